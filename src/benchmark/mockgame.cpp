@@ -0,0 +1,160 @@
+#include "mockgame.h"
+
+#include <executableinfo.h>
+#include <pluginsetting.h>
+#include <versioninfo.h>
+
+#include <utility>
+
+using MOBase::ExecutableForcedLoadSetting;
+using MOBase::ExecutableInfo;
+using MOBase::PluginSetting;
+using MOBase::VersionInfo;
+
+MockGame::MockGame(const QString& gamePath, QStringList primaryPlugins)
+    : m_PrimaryPlugins(std::move(primaryPlugins))
+{
+  setGamePath(gamePath);
+}
+
+QString MockGame::name() const
+{
+  return "Benchmark Support Plugin";
+}
+
+QString MockGame::localizedName() const
+{
+  return name();
+}
+
+QString MockGame::author() const
+{
+  return {};
+}
+
+QString MockGame::description() const
+{
+  return {};
+}
+
+VersionInfo MockGame::version() const
+{
+  return VersionInfo(1, 0, 0, VersionInfo::RELEASE_FINAL);
+}
+
+QList<PluginSetting> MockGame::settings() const
+{
+  return {};
+}
+
+QString MockGame::gameName() const
+{
+  return "Benchmark";
+}
+
+QString MockGame::displayGameName() const
+{
+  return gameName();
+}
+
+QList<ExecutableInfo> MockGame::executables() const
+{
+  return {};
+}
+
+QList<ExecutableForcedLoadSetting> MockGame::executableForcedLoads() const
+{
+  return {};
+}
+
+void MockGame::initializeProfile(const QDir&, ProfileSettings) const {}
+
+QString MockGame::steamAPPId() const
+{
+  return {};
+}
+
+QStringList MockGame::primaryPlugins() const
+{
+  return m_PrimaryPlugins;
+}
+
+QStringList MockGame::enabledPlugins() const
+{
+  return {};
+}
+
+QStringList MockGame::gameVariants() const
+{
+  return {};
+}
+
+QString MockGame::gameShortName() const
+{
+  return "Benchmark";
+}
+
+QString MockGame::lootGameName() const
+{
+  return gameShortName();
+}
+
+QStringList MockGame::primarySources() const
+{
+  return {};
+}
+
+QStringList MockGame::validShortNames() const
+{
+  return {};
+}
+
+QString MockGame::gameNexusName() const
+{
+  return {};
+}
+
+QStringList MockGame::iniFiles() const
+{
+  return {};
+}
+
+QStringList MockGame::DLCPlugins() const
+{
+  return {};
+}
+
+QStringList MockGame::CCPlugins() const
+{
+  return {};
+}
+
+int MockGame::nexusModOrganizerID() const
+{
+  return 0;
+}
+
+int MockGame::nexusGameID() const
+{
+  return 0;
+}
+
+QString MockGame::savegameExtension() const
+{
+  return "ess";
+}
+
+QString MockGame::savegameSEExtension() const
+{
+  return "skse";
+}
+
+std::shared_ptr<const GamebryoSaveGame> MockGame::makeSaveGame(QString) const
+{
+  return nullptr;
+}
+
+QString MockGame::identifyGamePath() const
+{
+  return m_GamePath;
+}
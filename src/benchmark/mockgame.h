@@ -0,0 +1,57 @@
+#ifndef MOCKGAME_H
+#define MOCKGAME_H
+
+#include <gamegamebryo.h>
+
+#include <QStringList>
+
+/**
+ * @brief Game installed in a given directory, with a fixed list of primary plugins.
+ *
+ * Only the directories and primary plugins are used by the plugin list files, the
+ * rest of the game interface returns empty values. The game-specific methods are not
+ * marked override because some of them were added in later uibase releases.
+ */
+class MockGame : public GameGamebryo
+{
+public:
+  MockGame(const QString& gamePath, QStringList primaryPlugins);
+
+  QString name() const;
+  QString localizedName() const;
+  QString author() const;
+  QString description() const;
+  MOBase::VersionInfo version() const;
+  QList<MOBase::PluginSetting> settings() const;
+
+  QString gameName() const;
+  QString displayGameName() const;
+  QList<MOBase::ExecutableInfo> executables() const;
+  QList<MOBase::ExecutableForcedLoadSetting> executableForcedLoads() const;
+  void initializeProfile(const QDir& directory, ProfileSettings settings) const;
+  QString steamAPPId() const;
+  QStringList primaryPlugins() const;
+  QStringList enabledPlugins() const;
+  QStringList gameVariants() const;
+  QString gameShortName() const;
+  QString lootGameName() const;
+  QStringList primarySources() const;
+  QStringList validShortNames() const;
+  QString gameNexusName() const;
+  QStringList iniFiles() const;
+  QStringList DLCPlugins() const;
+  QStringList CCPlugins() const;
+  int nexusModOrganizerID() const;
+  int nexusGameID() const;
+
+protected:
+  QString savegameExtension() const;
+  QString savegameSEExtension() const;
+  std::shared_ptr<const GamebryoSaveGame> makeSaveGame(QString filepath) const;
+  QString identifyGamePath() const;
+
+private:
+  QStringList m_PrimaryPlugins;
+};
+
+#endif  // MOCKGAME_H
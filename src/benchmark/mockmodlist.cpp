@@ -0,0 +1,80 @@
+#include "mockmodlist.h"
+
+using MOBase::IModInterface;
+using MOBase::IProfile;
+
+QString MockModList::displayName(const QString& internalName) const
+{
+  return internalName;
+}
+
+QStringList MockModList::allMods() const
+{
+  return {};
+}
+
+QStringList MockModList::allModsByProfilePriority(IProfile*) const
+{
+  return {};
+}
+
+IModInterface* MockModList::getMod(const QString&) const
+{
+  return nullptr;
+}
+
+bool MockModList::removeMod(IModInterface*)
+{
+  return false;
+}
+
+IModInterface* MockModList::renameMod(IModInterface*, const QString&)
+{
+  return nullptr;
+}
+
+MockModList::ModStates MockModList::state(const QString&) const
+{
+  return {};
+}
+
+bool MockModList::setActive(const QString&, bool)
+{
+  return false;
+}
+
+int MockModList::setActive(const QStringList&, bool)
+{
+  return 0;
+}
+
+int MockModList::priority(const QString&) const
+{
+  return -1;
+}
+
+bool MockModList::setPriority(const QString&, int)
+{
+  return false;
+}
+
+bool MockModList::onModInstalled(const std::function<void(IModInterface*)>&)
+{
+  return true;
+}
+
+bool MockModList::onModRemoved(const std::function<void(const QString&)>&)
+{
+  return true;
+}
+
+bool MockModList::onModStateChanged(
+    const std::function<void(const std::map<QString, ModStates>&)>&)
+{
+  return true;
+}
+
+bool MockModList::onModMoved(const std::function<void(const QString&, int, int)>&)
+{
+  return true;
+}
@@ -0,0 +1,35 @@
+#ifndef MOCKMODLIST_H
+#define MOCKMODLIST_H
+
+#include <imodlist.h>
+
+/**
+ * @brief Mod list without any mod, so every plugin is looked up in the data
+ * directory of the game.
+ */
+class MockModList : public MOBase::IModList
+{
+public:
+  virtual QString displayName(const QString& internalName) const override;
+  virtual QStringList allMods() const override;
+  virtual QStringList
+  allModsByProfilePriority(MOBase::IProfile* profile = nullptr) const override;
+  virtual MOBase::IModInterface* getMod(const QString& name) const override;
+  virtual bool removeMod(MOBase::IModInterface* mod) override;
+  virtual MOBase::IModInterface* renameMod(MOBase::IModInterface* mod,
+                                           const QString& name) override;
+  virtual ModStates state(const QString& name) const override;
+  virtual bool setActive(const QString& name, bool active) override;
+  virtual int setActive(const QStringList& names, bool active) override;
+  virtual int priority(const QString& name) const override;
+  virtual bool setPriority(const QString& name, int newPriority) override;
+  virtual bool
+  onModInstalled(const std::function<void(MOBase::IModInterface*)>& func) override;
+  virtual bool onModRemoved(const std::function<void(const QString&)>& func) override;
+  virtual bool onModStateChanged(
+      const std::function<void(const std::map<QString, ModStates>&)>& func) override;
+  virtual bool
+  onModMoved(const std::function<void(const QString&, int, int)>& func) override;
+};
+
+#endif  // MOCKMODLIST_H
@@ -0,0 +1,280 @@
+#include "mockorganizer.h"
+
+#include <ifiletree.h>
+#include <versioninfo.h>
+#include <versioning.h>
+
+using namespace MOBase;
+
+MockOrganizer::MockOrganizer(const QString& profilePath, const QString& basePath)
+    : m_BasePath(basePath),
+      m_Profile(std::make_unique<MockProfile>("Benchmark", profilePath)),
+      m_ModList(std::make_unique<MockModList>()), m_PluginList(nullptr),
+      m_ManagedGame(nullptr)
+{}
+
+void MockOrganizer::setManagedGame(const IPluginGame* game)
+{
+  m_ManagedGame = game;
+}
+
+void MockOrganizer::setPluginList(IPluginList* pluginList)
+{
+  m_PluginList = pluginList;
+}
+
+IModRepositoryBridge* MockOrganizer::createNexusBridge() const
+{
+  return nullptr;
+}
+
+QString MockOrganizer::profileName() const
+{
+  return m_Profile->name();
+}
+
+QString MockOrganizer::profilePath() const
+{
+  return m_Profile->absolutePath();
+}
+
+QString MockOrganizer::downloadsPath() const
+{
+  return m_BasePath + "/downloads";
+}
+
+QString MockOrganizer::overwritePath() const
+{
+  return m_BasePath + "/overwrite";
+}
+
+QString MockOrganizer::basePath() const
+{
+  return m_BasePath;
+}
+
+QString MockOrganizer::modsPath() const
+{
+  return m_BasePath + "/mods";
+}
+
+VersionInfo MockOrganizer::appVersion() const
+{
+  return VersionInfo(2, 5, 0, VersionInfo::RELEASE_FINAL);
+}
+
+Version MockOrganizer::version() const
+{
+  return Version(2, 5, 0);
+}
+
+IModInterface* MockOrganizer::createMod(GuessedValue<QString>&)
+{
+  return nullptr;
+}
+
+IPluginGame* MockOrganizer::getGame(const QString&) const
+{
+  return nullptr;
+}
+
+void MockOrganizer::modDataChanged(IModInterface*) {}
+
+bool MockOrganizer::isPluginEnabled(IPlugin*) const
+{
+  return true;
+}
+
+bool MockOrganizer::isPluginEnabled(const QString&) const
+{
+  return true;
+}
+
+QVariant MockOrganizer::pluginSetting(const QString&, const QString&) const
+{
+  return {};
+}
+
+void MockOrganizer::setPluginSetting(const QString&, const QString&, const QVariant&)
+{}
+
+QVariant MockOrganizer::persistent(const QString&, const QString&,
+                                   const QVariant& def) const
+{
+  return def;
+}
+
+void MockOrganizer::setPersistent(const QString&, const QString&, const QVariant&,
+                                  bool)
+{}
+
+QString MockOrganizer::pluginDataPath() const
+{
+  return m_BasePath + "/plugins/data";
+}
+
+IModInterface* MockOrganizer::installMod(const QString&, const QString&)
+{
+  return nullptr;
+}
+
+QString MockOrganizer::resolvePath(const QString&) const
+{
+  return {};
+}
+
+QStringList MockOrganizer::listDirectories(const QString&) const
+{
+  return {};
+}
+
+QStringList MockOrganizer::findFiles(const QString&,
+                                     const std::function<bool(const QString&)>&) const
+{
+  return {};
+}
+
+QStringList MockOrganizer::findFiles(const QString&, const QStringList&) const
+{
+  return {};
+}
+
+QStringList MockOrganizer::getFileOrigins(const QString&) const
+{
+  return {};
+}
+
+QList<IOrganizer::FileInfo>
+MockOrganizer::findFileInfos(const QString&,
+                             const std::function<bool(const FileInfo&)>&) const
+{
+  return {};
+}
+
+std::shared_ptr<const IFileTree> MockOrganizer::virtualFileTree() const
+{
+  return nullptr;
+}
+
+IDownloadManager* MockOrganizer::downloadManager() const
+{
+  return nullptr;
+}
+
+IPluginList* MockOrganizer::pluginList() const
+{
+  return m_PluginList;
+}
+
+IModList* MockOrganizer::modList() const
+{
+  return m_ModList.get();
+}
+
+IProfile* MockOrganizer::profile() const
+{
+  return m_Profile.get();
+}
+
+IGameFeatures* MockOrganizer::gameFeatures() const
+{
+  // without game features, no game plugins count as managed and their plugin list
+  // callbacks return immediately
+  return nullptr;
+}
+
+HANDLE MockOrganizer::startApplication(const QString&, const QStringList&,
+                                       const QString&, const QString&,
+                                       const QString&, bool)
+{
+  return HANDLE();
+}
+
+bool MockOrganizer::waitForApplication(HANDLE, bool, LPDWORD) const
+{
+  return false;
+}
+
+void MockOrganizer::refresh(bool) {}
+
+const IPluginGame* MockOrganizer::managedGame() const
+{
+  return m_ManagedGame;
+}
+
+bool MockOrganizer::onAboutToRun(const std::function<bool(const QString&)>&)
+{
+  return true;
+}
+
+bool MockOrganizer::onAboutToRun(
+    const std::function<bool(const QString&, const QDir&, const QString&)>&)
+{
+  return true;
+}
+
+bool MockOrganizer::onFinishedRun(
+    const std::function<void(const QString&, unsigned int)>&)
+{
+  return true;
+}
+
+bool MockOrganizer::onUserInterfaceInitialized(
+    const std::function<void(QMainWindow*)>&)
+{
+  return true;
+}
+
+bool MockOrganizer::onNextRefresh(const std::function<void()>&, bool)
+{
+  return true;
+}
+
+bool MockOrganizer::onProfileCreated(const std::function<void(IProfile*)>&)
+{
+  return true;
+}
+
+bool MockOrganizer::onProfileRenamed(
+    const std::function<void(IProfile*, const QString&, const QString&)>&)
+{
+  return true;
+}
+
+bool MockOrganizer::onProfileRemoved(const std::function<void(const QString&)>&)
+{
+  return true;
+}
+
+bool MockOrganizer::onProfileChanged(
+    const std::function<void(IProfile*, IProfile*)>&)
+{
+  return true;
+}
+
+bool MockOrganizer::onPluginSettingChanged(
+    const std::function<void(const QString&, const QString&, const QVariant&,
+                             const QVariant&)>&)
+{
+  return true;
+}
+
+bool MockOrganizer::onPluginEnabled(const std::function<void(const IPlugin*)>&)
+{
+  return true;
+}
+
+bool MockOrganizer::onPluginEnabled(const QString&, const std::function<void()>&)
+{
+  return true;
+}
+
+bool MockOrganizer::onPluginDisabled(const std::function<void(const IPlugin*)>&)
+{
+  return true;
+}
+
+bool MockOrganizer::onPluginDisabled(const QString&, const std::function<void()>&)
+{
+  return true;
+}
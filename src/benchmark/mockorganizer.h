@@ -0,0 +1,116 @@
+#ifndef MOCKORGANIZER_H
+#define MOCKORGANIZER_H
+
+#include "mockmodlist.h"
+#include "mockprofile.h"
+
+#include <imoinfo.h>
+
+#include <QDir>
+#include <QString>
+
+#include <memory>
+
+/**
+ * @brief Organizer for a single profile, stored in memory apart from the profile
+ * directory.
+ *
+ * Only the paths, the managed game and the lists are provided, everything else
+ * returns empty values and registered callbacks are never called. Methods are not
+ * marked override since IOrganizer gains and deprecates methods across uibase
+ * releases.
+ */
+class MockOrganizer : public MOBase::IOrganizer
+{
+public:
+  /**
+   * @param profilePath directory of the profile, holding the plugin lists
+   * @param basePath directory of the instance, holding the caches
+   */
+  MockOrganizer(const QString& profilePath, const QString& basePath);
+
+  void setManagedGame(const MOBase::IPluginGame* game);
+  void setPluginList(MOBase::IPluginList* pluginList);
+
+  MOBase::IModRepositoryBridge* createNexusBridge() const;
+  QString profileName() const;
+  QString profilePath() const;
+  QString downloadsPath() const;
+  QString overwritePath() const;
+  QString basePath() const;
+  QString modsPath() const;
+  MOBase::VersionInfo appVersion() const;
+  MOBase::Version version() const;
+  MOBase::IModInterface* createMod(MOBase::GuessedValue<QString>& name);
+  MOBase::IPluginGame* getGame(const QString& gameName) const;
+  void modDataChanged(MOBase::IModInterface* mod);
+  bool isPluginEnabled(MOBase::IPlugin* plugin) const;
+  bool isPluginEnabled(const QString& pluginName) const;
+  QVariant pluginSetting(const QString& pluginName, const QString& key) const;
+  void setPluginSetting(const QString& pluginName, const QString& key,
+                        const QVariant& value);
+  QVariant persistent(const QString& pluginName, const QString& key,
+                      const QVariant& def = QVariant()) const;
+  void setPersistent(const QString& pluginName, const QString& key,
+                     const QVariant& value, bool sync = true);
+  QString pluginDataPath() const;
+  MOBase::IModInterface* installMod(const QString& fileName,
+                                    const QString& nameSuggestion = QString());
+  QString resolvePath(const QString& fileName) const;
+  QStringList listDirectories(const QString& directoryName) const;
+  QStringList findFiles(const QString& path,
+                        const std::function<bool(const QString&)>& filter) const;
+  QStringList findFiles(const QString& path, const QStringList& filters) const;
+  QStringList getFileOrigins(const QString& fileName) const;
+  QList<FileInfo>
+  findFileInfos(const QString& path,
+                const std::function<bool(const FileInfo&)>& filter) const;
+  std::shared_ptr<const MOBase::IFileTree> virtualFileTree() const;
+
+  MOBase::IDownloadManager* downloadManager() const;
+  MOBase::IPluginList* pluginList() const;
+  MOBase::IModList* modList() const;
+  MOBase::IProfile* profile() const;
+  MOBase::IGameFeatures* gameFeatures() const;
+
+  HANDLE startApplication(const QString& executable,
+                          const QStringList& args = QStringList(),
+                          const QString& cwd = "", const QString& profile = "",
+                          const QString& forcedCustomOverwrite = "",
+                          bool ignoreCustomOverwrite = false);
+  bool waitForApplication(HANDLE handle, bool refresh = true,
+                          LPDWORD exitCode = nullptr) const;
+  void refresh(bool saveChanges = true);
+  const MOBase::IPluginGame* managedGame() const;
+
+  bool onAboutToRun(const std::function<bool(const QString&)>& func);
+  bool onAboutToRun(
+      const std::function<bool(const QString&, const QDir&, const QString&)>& func);
+  bool onFinishedRun(const std::function<void(const QString&, unsigned int)>& func);
+  bool onUserInterfaceInitialized(const std::function<void(QMainWindow*)>& func);
+  bool onNextRefresh(const std::function<void()>& func,
+                     bool immediateIfPossible = true);
+  bool onProfileCreated(const std::function<void(MOBase::IProfile*)>& func);
+  bool onProfileRenamed(
+      const std::function<void(MOBase::IProfile*, const QString&, const QString&)>&
+          func);
+  bool onProfileRemoved(const std::function<void(const QString&)>& func);
+  bool onProfileChanged(
+      const std::function<void(MOBase::IProfile*, MOBase::IProfile*)>& func);
+  bool onPluginSettingChanged(
+      const std::function<void(const QString&, const QString&, const QVariant&,
+                               const QVariant&)>& func);
+  bool onPluginEnabled(const std::function<void(const MOBase::IPlugin*)>& func);
+  bool onPluginEnabled(const QString& pluginName, const std::function<void()>& func);
+  bool onPluginDisabled(const std::function<void(const MOBase::IPlugin*)>& func);
+  bool onPluginDisabled(const QString& pluginName, const std::function<void()>& func);
+
+private:
+  QString m_BasePath;
+  std::unique_ptr<MockProfile> m_Profile;
+  std::unique_ptr<MockModList> m_ModList;
+  MOBase::IPluginList* m_PluginList;
+  const MOBase::IPluginGame* m_ManagedGame;
+};
+
+#endif  // MOCKORGANIZER_H
@@ -0,0 +1,231 @@
+#include "mockpluginlist.h"
+
+#include <algorithm>
+
+MockPluginList::MockPluginList(const QStringList& pluginNames)
+{
+  m_Plugins.reserve(pluginNames.size());
+  m_Index.reserve(pluginNames.size());
+  for (const QString& pluginName : pluginNames) {
+    m_Index.insert(pluginName, m_Plugins.size());
+    m_Plugins.push_back(
+        {pluginName, STATE_INACTIVE, static_cast<int>(m_Plugins.size())});
+  }
+}
+
+MockPluginList::Plugin* MockPluginList::find(const QString& name)
+{
+  auto it = m_Index.constFind(name);
+  return it != m_Index.constEnd() ? &m_Plugins[*it] : nullptr;
+}
+
+const MockPluginList::Plugin* MockPluginList::find(const QString& name) const
+{
+  auto it = m_Index.constFind(name);
+  return it != m_Index.constEnd() ? &m_Plugins[*it] : nullptr;
+}
+
+QStringList MockPluginList::pluginNames() const
+{
+  QStringList result;
+  result.reserve(m_Plugins.size());
+  for (const auto& plugin : m_Plugins) {
+    result.append(plugin.name);
+  }
+  return result;
+}
+
+MockPluginList::PluginStates MockPluginList::state(const QString& name) const
+{
+  const Plugin* plugin = find(name);
+  return plugin != nullptr ? plugin->state : PluginStates(STATE_MISSING);
+}
+
+void MockPluginList::setState(const QString& name, PluginStates state)
+{
+  Plugin* plugin = find(name);
+  if (plugin == nullptr || plugin->state == state) {
+    return;
+  }
+
+  plugin->state = state;
+
+  const std::map<QString, PluginStates> changed{{plugin->name, state}};
+  for (const auto& callback : m_OnPluginStateChanged) {
+    callback(changed);
+  }
+}
+
+int MockPluginList::priority(const QString& name) const
+{
+  const Plugin* plugin = find(name);
+  return plugin != nullptr ? plugin->priority : -1;
+}
+
+bool MockPluginList::setPriority(const QString& name, int newPriority)
+{
+  const Plugin* plugin = find(name);
+  if (plugin == nullptr) {
+    return false;
+  }
+
+  std::vector<const Plugin*> order;
+  order.reserve(m_Plugins.size());
+  for (const auto& other : m_Plugins) {
+    if (&other != plugin) {
+      order.push_back(&other);
+    }
+  }
+  std::sort(order.begin(), order.end(), [](const Plugin* lhs, const Plugin* rhs) {
+    return lhs->priority < rhs->priority;
+  });
+  order.insert(order.begin() + std::clamp<qsizetype>(newPriority, 0, order.size()),
+               plugin);
+
+  QStringList loadOrder;
+  loadOrder.reserve(order.size());
+  for (const Plugin* other : order) {
+    loadOrder.append(other->name);
+  }
+  setLoadOrder(loadOrder);
+
+  return true;
+}
+
+int MockPluginList::loadOrder(const QString& name) const
+{
+  const Plugin* plugin = find(name);
+  if (plugin == nullptr || plugin->state != STATE_ACTIVE) {
+    return -1;
+  }
+
+  return static_cast<int>(std::count_if(
+      m_Plugins.begin(), m_Plugins.end(), [plugin](const Plugin& other) {
+        return other.state == STATE_ACTIVE && other.priority < plugin->priority;
+      }));
+}
+
+void MockPluginList::setLoadOrder(const QStringList& pluginList)
+{
+  // listed plugins come first in the given order, the others keep their relative
+  // order after them
+  std::vector<Plugin*> order;
+  order.reserve(m_Plugins.size());
+
+  std::vector<bool> placed(m_Plugins.size(), false);
+  for (const QString& pluginName : pluginList) {
+    auto it = m_Index.constFind(pluginName);
+    if (it != m_Index.constEnd() && !placed[*it]) {
+      placed[*it] = true;
+      order.push_back(&m_Plugins[*it]);
+    }
+  }
+
+  std::vector<Plugin*> rest;
+  for (std::size_t i = 0; i < m_Plugins.size(); ++i) {
+    if (!placed[i]) {
+      rest.push_back(&m_Plugins[i]);
+    }
+  }
+  std::sort(rest.begin(), rest.end(), [](const Plugin* lhs, const Plugin* rhs) {
+    return lhs->priority < rhs->priority;
+  });
+  order.insert(order.end(), rest.begin(), rest.end());
+
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    const int oldPriority = order[i]->priority;
+    const int newPriority = static_cast<int>(i);
+    if (oldPriority == newPriority) {
+      continue;
+    }
+
+    order[i]->priority = newPriority;
+    for (const auto& callback : m_OnPluginMoved) {
+      callback(order[i]->name, oldPriority, newPriority);
+    }
+  }
+}
+
+QStringList MockPluginList::masters(const QString&) const
+{
+  return {};
+}
+
+QString MockPluginList::origin(const QString& name) const
+{
+  return find(name) != nullptr ? QStringLiteral("data") : QString();
+}
+
+bool MockPluginList::onRefreshed(const std::function<void()>&)
+{
+  return true;
+}
+
+bool MockPluginList::onPluginMoved(
+    const std::function<void(const QString&, int, int)>& func)
+{
+  m_OnPluginMoved.push_back(func);
+  return true;
+}
+
+bool MockPluginList::onPluginStateChanged(
+    const std::function<void(const std::map<QString, PluginStates>&)>& func)
+{
+  m_OnPluginStateChanged.push_back(func);
+  return true;
+}
+
+bool MockPluginList::hasMasterExtension(const QString& name) const
+{
+  return name.endsWith(".esm", Qt::CaseInsensitive);
+}
+
+bool MockPluginList::hasLightExtension(const QString& name) const
+{
+  return name.endsWith(".esl", Qt::CaseInsensitive);
+}
+
+bool MockPluginList::isMasterFlagged(const QString&) const
+{
+  return false;
+}
+
+bool MockPluginList::isMediumFlagged(const QString&) const
+{
+  return false;
+}
+
+bool MockPluginList::isLightFlagged(const QString&) const
+{
+  return false;
+}
+
+bool MockPluginList::isBlueprintFlagged(const QString&) const
+{
+  return false;
+}
+
+bool MockPluginList::hasNoRecords(const QString&) const
+{
+  return false;
+}
+
+int MockPluginList::formVersion(const QString&) const
+{
+  return 0;
+}
+
+float MockPluginList::headerVersion(const QString&) const
+{
+  return 0.0f;
+}
+
+QString MockPluginList::author(const QString&) const
+{
+  return {};
+}
+
+QString MockPluginList::description(const QString&) const
+{
+  return {};
+}
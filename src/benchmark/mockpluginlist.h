@@ -0,0 +1,78 @@
+#ifndef MOCKPLUGINLIST_H
+#define MOCKPLUGINLIST_H
+
+#include <gamebryopluginname.h>
+#include <ipluginlist.h>
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+#include <map>
+#include <vector>
+
+/**
+ * @brief In-memory plugin list. Names are looked up case-insensitively like in the
+ * plugin list of Mod Organizer, and state changes and moves are reported to the
+ * registered callbacks. The list is never refreshed.
+ *
+ * The header queries are not used by the plugin list files and return defaults. The
+ * methods are not marked override because the set of header queries differs between
+ * uibase releases.
+ */
+class MockPluginList : public MOBase::IPluginList
+{
+public:
+  /**
+   * @param pluginNames plugins in the list, all inactive, in priority order
+   */
+  explicit MockPluginList(const QStringList& pluginNames);
+
+  QStringList pluginNames() const;
+  PluginStates state(const QString& name) const;
+  void setState(const QString& name, PluginStates state);
+  int priority(const QString& name) const;
+  bool setPriority(const QString& name, int newPriority);
+  int loadOrder(const QString& name) const;
+  void setLoadOrder(const QStringList& pluginList);
+  QStringList masters(const QString& name) const;
+  QString origin(const QString& name) const;
+
+  bool onRefreshed(const std::function<void()>& callback);
+  bool onPluginMoved(const std::function<void(const QString&, int, int)>& func);
+  bool onPluginStateChanged(
+      const std::function<void(const std::map<QString, PluginStates>&)>& func);
+
+  bool hasMasterExtension(const QString& name) const;
+  bool hasLightExtension(const QString& name) const;
+  bool isMasterFlagged(const QString& name) const;
+  bool isMediumFlagged(const QString& name) const;
+  bool isLightFlagged(const QString& name) const;
+  bool isBlueprintFlagged(const QString& name) const;
+  bool hasNoRecords(const QString& name) const;
+  int formVersion(const QString& name) const;
+  float headerVersion(const QString& name) const;
+  QString author(const QString& name) const;
+  QString description(const QString& name) const;
+
+private:
+  struct Plugin
+  {
+    QString name;
+    PluginStates state;
+    int priority;
+  };
+
+  Plugin* find(const QString& name);
+  const Plugin* find(const QString& name) const;
+
+  std::vector<Plugin> m_Plugins;
+  QHash<GamebryoPluginName, std::size_t> m_Index;
+
+  std::vector<std::function<void(const QString&, int, int)>> m_OnPluginMoved;
+  std::vector<std::function<void(const std::map<QString, PluginStates>&)>>
+      m_OnPluginStateChanged;
+};
+
+#endif  // MOCKPLUGINLIST_H
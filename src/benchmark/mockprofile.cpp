@@ -0,0 +1,40 @@
+#include "mockprofile.h"
+
+#include <utility>
+
+MockProfile::MockProfile(QString name, QString path)
+    : m_Name(std::move(name)), m_Path(std::move(path))
+{}
+
+QString MockProfile::name() const
+{
+  return m_Name;
+}
+
+QString MockProfile::absolutePath() const
+{
+  return m_Path;
+}
+
+bool MockProfile::localSavesEnabled() const
+{
+  return false;
+}
+
+bool MockProfile::localSettingsEnabled() const
+{
+  return false;
+}
+
+bool MockProfile::invalidationActive(bool* supported) const
+{
+  if (supported != nullptr) {
+    *supported = false;
+  }
+  return false;
+}
+
+QString MockProfile::absoluteIniFilePath(QString iniFile) const
+{
+  return m_Path + "/" + iniFile;
+}
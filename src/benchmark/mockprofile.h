@@ -0,0 +1,29 @@
+#ifndef MOCKPROFILE_H
+#define MOCKPROFILE_H
+
+#include <iprofile.h>
+
+#include <QString>
+
+/**
+ * @brief Profile stored in a directory, without local saves, local settings or
+ * archive invalidation.
+ */
+class MockProfile : public MOBase::IProfile
+{
+public:
+  MockProfile(QString name, QString path);
+
+  virtual QString name() const override;
+  virtual QString absolutePath() const override;
+  virtual bool localSavesEnabled() const override;
+  virtual bool localSettingsEnabled() const override;
+  virtual bool invalidationActive(bool* supported) const override;
+  virtual QString absoluteIniFilePath(QString iniFile) const override;
+
+private:
+  QString m_Name;
+  QString m_Path;
+};
+
+#endif  // MOCKPROFILE_H
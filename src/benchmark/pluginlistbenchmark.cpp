@@ -0,0 +1,318 @@
+#include "mockgame.h"
+#include "mockorganizer.h"
+#include "mockpluginlist.h"
+
+#include <creationgameplugins.h>
+#include <gamebryogameplugins.h>
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <vector>
+
+using MOBase::GamePlugins;
+using MOBase::IPluginList;
+
+namespace
+{
+std::atomic<std::uint64_t> s_Allocations{0};
+}
+
+// allocations are counted in malloc() where it can be replaced, so the storage of Qt
+// containers is included; elsewhere only operator new of this program is counted
+#ifdef __GLIBC__
+extern "C"
+{
+  void* __libc_malloc(std::size_t size);
+  void* __libc_calloc(std::size_t count, std::size_t size);
+  void* __libc_realloc(void* ptr, std::size_t size);
+
+  void* malloc(std::size_t size) noexcept
+  {
+    s_Allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+  }
+
+  void* calloc(std::size_t count, std::size_t size) noexcept
+  {
+    s_Allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+  }
+
+  void* realloc(void* ptr, std::size_t size) noexcept
+  {
+    s_Allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+  }
+}
+#else
+void* operator new(std::size_t size)
+{
+  s_Allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size != 0 ? size : 1)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+#endif
+
+namespace
+{
+const QStringList PRIMARY_PLUGINS = {"Benchmark.esm", "Update.esm", "Dawnguard.esm"};
+
+/**
+ * @brief Generates plugin names in mixed case, some of them with characters outside
+ * of ASCII, which are compared through full case folding.
+ */
+QStringList generatePluginNames(qsizetype count)
+{
+  const QString stems[] = {
+      QStringLiteral("Unofficial Patch"), QStringLiteral("\u00dcBER Weapons"),
+      QStringLiteral("Caf\u00e9 Overhaul"), QStringLiteral("\u00d8rsted Lighting"),
+      QStringLiteral("Na\u00efve AI"),      QStringLiteral("Grass Cache"),
+  };
+  const QString extensions[] = {".esp", ".ESP", ".esm", ".esl"};
+
+  QStringList names;
+  names.reserve(count);
+  for (qsizetype i = 0; i < count; ++i) {
+    QString name = QString("%1 %2%3")
+                       .arg(stems[i % std::size(stems)])
+                       .arg(i, 4, 10, QChar('0'))
+                       .arg(extensions[i % std::size(extensions)]);
+    if (i % 3 == 1) {
+      name = name.toUpper();
+    } else if (i % 3 == 2) {
+      name = name.toLower();
+    }
+    names.append(name);
+  }
+
+  return names;
+}
+
+/**
+ * @brief Creates empty plugins in the data directory. Their file times are shuffled
+ * and shared by a few plugins each, so sorting by file time has to break ties.
+ */
+void createPlugins(const QDir& dataDirectory, const QStringList& pluginNames)
+{
+  const QDateTime base = QDateTime::currentDateTime().addDays(-1);
+
+  for (qsizetype i = 0; i < pluginNames.size(); ++i) {
+    QFile file(dataDirectory.absoluteFilePath(pluginNames[i]));
+    if (!file.open(QIODevice::WriteOnly)) {
+      qFatal("cannot create %s", qUtf8Printable(file.fileName()));
+    }
+
+    const qint64 slot = (i * 7919) % pluginNames.size() / 4;
+    file.setFileTime(base.addSecs(slot), QFileDevice::FileModificationTime);
+  }
+}
+
+/**
+ * @brief Sets the modification time of a file to some time in the future, newer
+ * than the last read of the plugin lists.
+ */
+void touch(const QString& filePath, int seconds)
+{
+  QFile file(filePath);
+  if (file.open(QIODevice::ReadWrite)) {
+    file.setFileTime(QDateTime::currentDateTime().addSecs(seconds),
+                     QFileDevice::FileModificationTime);
+  }
+}
+
+struct Measurement
+{
+  double medianMicroseconds;
+  double allocations;
+};
+
+/**
+ * @brief Runs an operation a number of times, after preparing each run outside of
+ * the measurement.
+ *
+ * @return median latency and average allocations of one run
+ */
+Measurement measure(int iterations, const std::function<void(int)>& prepare,
+                    const std::function<void()>& operation)
+{
+  std::vector<qint64> times;
+  times.reserve(iterations);
+  std::uint64_t allocations = 0;
+
+  for (int i = 0; i < iterations; ++i) {
+    prepare(i);
+
+    QElapsedTimer timer;
+    const std::uint64_t before = s_Allocations.load(std::memory_order_relaxed);
+    timer.start();
+
+    operation();
+
+    times.push_back(timer.nsecsElapsed());
+    allocations += s_Allocations.load(std::memory_order_relaxed) - before;
+  }
+
+  std::sort(times.begin(), times.end());
+  return {times[times.size() / 2] / 1000.0,
+          static_cast<double>(allocations) / iterations};
+}
+
+void report(qsizetype pluginCount, const char* implementation, const char* operation,
+            const Measurement& measurement)
+{
+  std::printf("%7lld  %-14s %-24s %12.1f %14.1f\n",
+              static_cast<long long>(pluginCount), implementation, operation,
+              measurement.medianMicroseconds, measurement.allocations);
+}
+
+/**
+ * @brief Benchmarks the plugin list files of a generated profile.
+ *
+ * @param implementation name of the game plugins in the report
+ * @param pluginCount number of plugins in the profile, primary plugins included
+ */
+template <typename Plugins>
+void run(const char* implementation, qsizetype pluginCount)
+{
+  QTemporaryDir root;
+  if (!root.isValid()) {
+    qFatal("cannot create a temporary directory");
+  }
+
+  const QDir rootDirectory(root.path());
+  rootDirectory.mkpath("game/Data");
+  rootDirectory.mkpath("profile");
+  rootDirectory.mkpath("base");
+
+  const QStringList pluginNames =
+      PRIMARY_PLUGINS + generatePluginNames(pluginCount - PRIMARY_PLUGINS.size());
+  createPlugins(rootDirectory.absoluteFilePath("game/Data"), pluginNames);
+
+  MockOrganizer organizer(rootDirectory.absoluteFilePath("profile"),
+                          rootDirectory.absoluteFilePath("base"));
+  MockPluginList pluginList(pluginNames);
+  MockGame game(rootDirectory.absoluteFilePath("game"), PRIMARY_PLUGINS);
+  game.init(&organizer);
+  organizer.setManagedGame(&game);
+  organizer.setPluginList(&pluginList);
+
+  Plugins instance(&organizer);
+  GamePlugins& plugins = instance;
+
+  // the lists are only written once they have been read, every other plugin is
+  // active in them
+  plugins.readPluginLists(&pluginList);
+  for (qsizetype i = 0; i < pluginNames.size(); i += 2) {
+    pluginList.setState(pluginNames[i], IPluginList::STATE_ACTIVE);
+  }
+  plugins.writePluginLists(&pluginList);
+
+  const int iterations = std::max<int>(10, 20000 / pluginCount);
+  const auto none      = [](int) {};
+
+  report(pluginCount, implementation, "write (changed)",
+         measure(
+             iterations,
+             [&](int i) {
+               const QString& pluginName =
+                   pluginNames[PRIMARY_PLUGINS.size() +
+                               i % (pluginNames.size() - PRIMARY_PLUGINS.size())];
+               pluginList.setState(pluginName,
+                                   pluginList.state(pluginName) ==
+                                           IPluginList::STATE_ACTIVE
+                                       ? IPluginList::STATE_INACTIVE
+                                       : IPluginList::STATE_ACTIVE);
+             },
+             [&]() {
+               plugins.writePluginLists(&pluginList);
+             }));
+
+  report(pluginCount, implementation, "write (unchanged)",
+         measure(iterations, none, [&]() {
+           plugins.writePluginLists(&pluginList);
+         }));
+
+  report(pluginCount, implementation, "read (unchanged)",
+         measure(iterations, none, [&]() {
+           plugins.readPluginLists(&pluginList);
+         }));
+
+  report(pluginCount, implementation, "getLoadOrder",
+         measure(iterations, none, [&]() {
+           plugins.getLoadOrder();
+         }));
+
+  // a newer plugins.txt makes the load order come from the file times of the plugins
+  const QString pluginsPath = rootDirectory.absoluteFilePath("profile/plugins.txt");
+  report(pluginCount, implementation, "read (plugins.txt newer)",
+         measure(
+             iterations,
+             [&](int i) {
+               touch(pluginsPath, 60 + i);
+             },
+             [&]() {
+               plugins.readPluginLists(&pluginList);
+             }));
+
+  report(pluginCount, implementation, "read (new instance)",
+         measure(iterations, none, [&]() {
+           Plugins other(&organizer);
+           static_cast<GamePlugins&>(other).readPluginLists(&pluginList);
+         }));
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  QCoreApplication application(argc, argv);
+
+  std::printf("%7s  %-14s %-24s %12s %14s\n", "plugins", "implementation",
+              "operation", "median (us)", "allocations");
+
+  for (qsizetype pluginCount : {100, 1000, 5000}) {
+    run<GamebryoGamePlugins>("gamebryo", pluginCount);
+    run<CreationGamePlugins>("creation", pluginCount);
+  }
+
+  return 0;
+}
@@ -1,7 +1,8 @@
 #include "creationgameplugins.h"
+#include <gamebryopluginlistfile.h>
+#include <gamebryopluginstates.h>
+#include <igamefeatures.h>
 #include <ipluginlist.h>
-#include <report.h>
-#include <safewritefile.h>
 #include <scopeguard.h>
 
 #include <QDir>
@@ -9,15 +10,182 @@
 #include <QStringEncoder>
 #include <QStringList>
 
+using MOBase::GamePlugins;
+using MOBase::IGameFeatures;
 using MOBase::IOrganizer;
 using MOBase::IPluginGame;
 using MOBase::IPluginList;
-using MOBase::reportError;
-using MOBase::SafeWriteFile;
 
 CreationGamePlugins::CreationGamePlugins(IOrganizer* organizer)
-    : GamebryoGamePlugins(organizer)
-{}
+    : GamebryoGamePlugins(organizer), m_Alive(std::make_shared<bool>(true)),
+      m_PrimaryPluginsGame(nullptr), m_SlotsOrderDirty(true), m_SlotsExceeded(false)
+{
+  IPluginList* pluginList = organizer->pluginList();
+  if (pluginList == nullptr) {
+    return;
+  }
+
+  // the callbacks cannot be unregistered, they do nothing once this is destroyed or
+  // for the features of the games that are installed but not managed
+  pluginList->onRefreshed([this, alive = std::weak_ptr<bool>(m_Alive)]() {
+    if (alive.expired() || !isManaged()) {
+      return;
+    }
+
+    refreshPluginSlots();
+  });
+
+  pluginList->onPluginMoved(
+      [this, alive = std::weak_ptr<bool>(m_Alive)](const QString&, int, int) {
+        if (alive.expired() || !isManaged()) {
+          return;
+        }
+
+        m_SlotsOrderDirty = true;
+      });
+
+  pluginList->onPluginStateChanged(
+      [this, alive = std::weak_ptr<bool>(m_Alive)](
+          const std::map<QString, IPluginList::PluginStates>& states) {
+        if (alive.expired() || !isManaged()) {
+          return;
+        }
+
+        for (const auto& [pluginName, state] : states) {
+          m_Slots.setActive(pluginName, state == IPluginList::STATE_ACTIVE);
+        }
+        checkPluginSlots();
+      });
+}
+
+void CreationGamePlugins::readPluginLists(IPluginList* pluginList)
+{
+  // the primary plugins of some games depend on files that may have changed, and the
+  // plugin list is read before it reports being refreshed
+  m_PrimaryPluginsGame = nullptr;
+
+  GamebryoGamePlugins::readPluginLists(pluginList);
+}
+
+bool CreationGamePlugins::isManaged() const
+{
+  const IGameFeatures* features = organizer()->gameFeatures();
+  return features != nullptr && features->gameFeature<GamePlugins>().get() == this;
+}
+
+const QStringList& CreationGamePlugins::primaryPlugins()
+{
+  const IPluginGame* game = organizer()->managedGame();
+  if (game != m_PrimaryPluginsGame) {
+    m_PrimaryPlugins = game->primaryPlugins();
+
+    m_PrimaryPluginsIndex.clear();
+    m_PrimaryPluginsIndex.reserve(m_PrimaryPlugins.size());
+    for (const QString& pluginName : m_PrimaryPlugins) {
+      m_PrimaryPluginsIndex.insert(pluginName);
+    }
+
+    m_PrimaryPluginsGame = game;
+  }
+
+  return m_PrimaryPlugins;
+}
+
+bool CreationGamePlugins::isPrimaryPlugin(const QString& pluginName)
+{
+  primaryPlugins();
+  return m_PrimaryPluginsIndex.contains(pluginName);
+}
+
+const CreationPluginSlots& CreationGamePlugins::pluginSlots()
+{
+  if (m_SlotsOrderDirty) {
+    const IPluginList* pluginList = organizer()->pluginList();
+
+    QStringList plugins = pluginList->pluginNames();
+    std::sort(plugins.begin(), plugins.end(),
+              [pluginList](const QString& lhs, const QString& rhs) {
+                return pluginList->priority(lhs) < pluginList->priority(rhs);
+              });
+
+    m_Slots.setLoadOrder(plugins);
+    m_SlotsOrderDirty = false;
+  }
+
+  return m_Slots;
+}
+
+CreationPluginSlots::Type
+CreationGamePlugins::pluginSlotType(const GamebryoPluginHeader* header,
+                                    const QString& pluginName)
+{
+  const bool mediumSupported = mediumPluginsAreSupported();
+
+  if (header == nullptr) {
+    return pluginName.endsWith(".esl", Qt::CaseInsensitive)
+               ? CreationPluginSlots::Type::Light
+               : CreationPluginSlots::Type::Full;
+  }
+
+  // the game gives precedence to the light flag if both are set
+  if (header->isLight(mediumSupported)) {
+    return CreationPluginSlots::Type::Light;
+  } else if (mediumSupported && header->isMediumFlagged()) {
+    return CreationPluginSlots::Type::Medium;
+  } else {
+    return CreationPluginSlots::Type::Full;
+  }
+}
+
+void CreationGamePlugins::refreshPluginSlots()
+{
+  const IPluginList* pluginList = organizer()->pluginList();
+  const QStringList plugins     = pluginList->pluginNames();
+
+  // headers come from the cache, only plugins that changed on disk are read
+  const auto headers = pluginHeaders(plugins);
+
+  m_Slots.clear();
+  m_Slots.setMediumPluginsSupported(mediumPluginsAreSupported());
+
+  for (qsizetype i = 0; i < plugins.size(); ++i) {
+    m_Slots.setPlugin(plugins[i], pluginSlotType(headers[i].get(), plugins[i]),
+                      pluginList->state(plugins[i]) == IPluginList::STATE_ACTIVE);
+  }
+
+  m_SlotsOrderDirty = true;
+  checkPluginSlots();
+}
+
+void CreationGamePlugins::checkPluginSlots()
+{
+  // only warn once when a limit is crossed, not on every change past it
+  const bool exceeded = m_Slots.exceedsLimits();
+  if (exceeded == m_SlotsExceeded) {
+    return;
+  }
+  m_SlotsExceeded = exceeded;
+
+  if (!exceeded) {
+    return;
+  }
+
+  const auto usage  = m_Slots.usage();
+  const auto limits = m_Slots.limits();
+
+  if (usage.full > limits.full) {
+    qWarning("%d full plugins are active, the game can only load %d", usage.full,
+             limits.full);
+  }
+  if (usage.medium > limits.medium) {
+    qWarning("%d medium plugins are active, the game can only load %d", usage.medium,
+             limits.medium);
+  }
+  if (usage.light > limits.light) {
+    qWarning("%d light plugins are active, the game can only load %d", usage.light,
+             limits.light);
+  }
+}
 
 QStringList CreationGamePlugins::getLoadOrder()
 {
@@ -36,144 +204,64 @@ QStringList CreationGamePlugins::getLoadOrder()
   }
 }
 
-void CreationGamePlugins::writePluginList(const IPluginList* pluginList,
+bool CreationGamePlugins::writePluginList(const GamebryoPluginListSnapshot& snapshot,
                                           const QString& filePath)
 {
-  SafeWriteFile file(filePath);
-
-  QStringEncoder encoder(QStringConverter::Encoding::System);
-
-  file->resize(0);
-
-  file->write(
-      encoder.encode("# This file was automatically generated by Mod Organizer.\r\n"));
-
-  bool invalidFileNames = false;
-  int writtenCount      = 0;
-
-  QStringList plugins = pluginList->pluginNames();
-  std::sort(plugins.begin(), plugins.end(),
-            [pluginList](const QString& lhs, const QString& rhs) {
-              return pluginList->priority(lhs) < pluginList->priority(rhs);
-            });
+  GamebryoPluginListWriter writer(QStringConverter::Encoding::System);
 
-  QStringList PrimaryPlugins = organizer()->managedGame()->primaryPlugins();
-  QStringList DLCPlugins     = organizer()->managedGame()->DLCPlugins();
-  QSet<QString> ManagedMods =
-      QSet<QString>(PrimaryPlugins.begin(), PrimaryPlugins.end());
-  QSet<QString> DLCSet = QSet<QString>(DLCPlugins.begin(), DLCPlugins.end());
-  ManagedMods.subtract(DLCSet);
-  PrimaryPlugins.append(QList<QString>(ManagedMods.begin(), ManagedMods.end()));
+  writer.addComment(u"This file was automatically generated by Mod Organizer.");
 
   // TODO: do not write plugins in OFFICIAL_FILES container
-  for (const QString& pluginName : plugins) {
-    if (!PrimaryPlugins.contains(pluginName, Qt::CaseInsensitive)) {
-      if (pluginList->state(pluginName) == IPluginList::STATE_ACTIVE) {
-        auto result = encoder.encode(pluginName);
-        if (encoder.hasError()) {
-          invalidFileNames = true;
-          qCritical("invalid plugin name %s", qUtf8Printable(pluginName));
-        } else {
-          file->write("*");
-          file->write(result);
-        }
-        file->write("\r\n");
-        ++writtenCount;
-      } else {
-        auto result = encoder.encode(pluginName);
-        if (encoder.hasError()) {
-          invalidFileNames = true;
-          qCritical("invalid plugin name %s", qUtf8Printable(pluginName));
-        } else {
-          file->write(result);
-        }
-        file->write("\r\n");
-        ++writtenCount;
-      }
+  for (const auto& plugin : snapshot.plugins()) {
+    if (!isPrimaryPlugin(plugin.name)) {
+      writer.addPlugin(plugin.name, plugin.state == IPluginList::STATE_ACTIVE);
     }
   }
 
-  if (invalidFileNames) {
-    reportError(QObject::tr("Some of your plugins have invalid names! These "
-                            "plugins can not be loaded by the game. Please see "
-                            "mo_interface.log for a list of affected plugins "
-                            "and rename them."));
-  }
+  commitListFile(writer, filePath);
 
-  file.commitIfDifferent(m_LastSaveHash[filePath]);
+  return !writer.hasInvalidNames();
 }
 
 QStringList CreationGamePlugins::readPluginList(MOBase::IPluginList* pluginList)
 {
-  const auto plugins        = pluginList->pluginNames();
-  const auto primaryPlugins = organizer()->managedGame()->primaryPlugins();
-  QStringList loadOrder(primaryPlugins);
+  const auto plugins = pluginList->pluginNames();
+  QStringList loadOrder(primaryPlugins());
 
+  GamebryoPluginStates states(pluginList);
   for (const QString& pluginName : loadOrder) {
-    if (pluginList->state(pluginName) != IPluginList::STATE_MISSING) {
-      pluginList->setState(pluginName, IPluginList::STATE_ACTIVE);
-    }
+    states.set(pluginName, IPluginList::STATE_ACTIVE);
   }
 
   QString filePath = getPluginsPath();
-  QFile file(filePath);
-  if (!file.open(QIODevice::ReadOnly)) {
-    qWarning("%s not found", qUtf8Printable(filePath));
+  const auto pluginsTxt = readListFile(filePath, QStringConverter::Encoding::System);
+  if (!pluginsTxt || QFileInfo(filePath).size() == 0) {
+    // MO stores at least a header in the file. if it's missing or completely empty
+    // the file is broken
+    qWarning("%s not found or empty", qUtf8Printable(filePath));
+    states.apply();
     return loadOrder;
   }
-  ON_BLOCK_EXIT([&]() {
-    file.close();
-  });
 
-  if (file.size() == 0) {
-    // MO stores at least a header in the file. if it's completely empty the
-    // file is broken
-    qWarning("%s empty", qUtf8Printable(filePath));
-    return loadOrder;
-  }
-
-  QStringList pluginsFound;
-  while (!file.atEnd()) {
-    QByteArray line = file.readLine();
-    QString pluginName;
-    if ((line.size() > 0) && (line.at(0) != '#')) {
-      pluginName = QStringEncoder(QStringConverter::Encoding::System)
-                       .encode(line.trimmed().constData());
-    }
-    if (!primaryPlugins.contains(pluginName, Qt::CaseInsensitive)) {
-      if (pluginName.startsWith('*')) {
-        pluginName.remove(0, 1);
-        if (pluginName.size() > 0) {
-          pluginList->setState(pluginName, IPluginList::STATE_ACTIVE);
-          pluginsFound.append(pluginName);
-          if (!loadOrder.contains(pluginName, Qt::CaseInsensitive)) {
-            loadOrder.append(pluginName);
-          }
-        }
-      } else {
-        if (pluginName.size() > 0) {
-          pluginList->setState(pluginName, IPluginList::STATE_INACTIVE);
-          pluginsFound.append(pluginName);
-          if (!loadOrder.contains(pluginName, Qt::CaseInsensitive)) {
-            loadOrder.append(pluginName);
-          }
-        }
+  for (const auto& line : *pluginsTxt) {
+    const QString& pluginName = line.name;
+    if (!isPrimaryPlugin(pluginName)) {
+      // states holds exactly the plugins that are already in the load order
+      if (!states.contains(pluginName)) {
+        loadOrder.append(pluginName);
       }
-    } else {
-      pluginName.remove(0, 1);
-      pluginsFound.append(pluginName);
+      states.set(pluginName, line.active ? IPluginList::STATE_ACTIVE
+                                         : IPluginList::STATE_INACTIVE);
     }
   }
 
-  file.close();
-
-  // set all plugins not found inactive
+  // set all plugins not found inactive, primary plugins stay active
   for (const auto& pluginName : plugins) {
-    if (!pluginsFound.contains(pluginName, Qt::CaseInsensitive)) {
-      pluginList->setState(pluginName, IPluginList::STATE_INACTIVE);
-    }
+    states.setDefault(pluginName, IPluginList::STATE_INACTIVE);
   }
 
+  states.apply();
+
   return loadOrder;
 }
 
@@ -1,25 +1,69 @@
 #ifndef CREATIONGAMEPLUGINS_H
 #define CREATIONGAMEPLUGINS_H
 
+#include "creationpluginslots.h"
+
+#include <QSet>
 #include <gamebryogameplugins.h>
+#include <gamebryopluginname.h>
 #include <imoinfo.h>
 #include <iplugingame.h>
 #include <map>
+#include <memory>
 
 class CreationGamePlugins : public GamebryoGamePlugins
 {
 public:
   CreationGamePlugins(MOBase::IOrganizer* organizer);
 
+  // the plugin list callbacks are tied to the instance that registered them
+  CreationGamePlugins(const CreationGamePlugins&)            = delete;
+  CreationGamePlugins& operator=(const CreationGamePlugins&) = delete;
+
+  virtual void readPluginLists(MOBase::IPluginList* pluginList) override;
+
+  /**
+   * @brief Returns the FormID slots used by the active plugins. Usage is kept up to
+   * date as plugins are enabled or disabled.
+   */
+  const CreationPluginSlots& pluginSlots();
+
 protected:
-  virtual void writePluginList(const MOBase::IPluginList* pluginList,
+  using GamebryoGamePlugins::writePluginList;
+
+  virtual bool writePluginList(const GamebryoPluginListSnapshot& snapshot,
                                const QString& filePath) override;
   virtual QStringList readPluginList(MOBase::IPluginList* pluginList) override;
   virtual QStringList getLoadOrder() override;
   virtual bool lightPluginsAreSupported() override;
 
 private:
-  std::map<QString, QByteArray> m_LastSaveHash;
+  // true if this is the plugin feature of the managed game, every installed game
+  // registers one
+  bool isManaged() const;
+
+  // primary plugins of the managed game, refreshed when the game changes or the
+  // plugin lists are read
+  const QStringList& primaryPlugins();
+  bool isPrimaryPlugin(const QString& pluginName);
+
+  CreationPluginSlots::Type pluginSlotType(const GamebryoPluginHeader* header,
+                                           const QString& pluginName);
+  void refreshPluginSlots();
+  void checkPluginSlots();
+
+private:
+  // shared with the plugin list callbacks, which only keep a weak reference to it
+  std::shared_ptr<bool> m_Alive;
+
+  const MOBase::IPluginGame* m_PrimaryPluginsGame;
+  QStringList m_PrimaryPlugins;
+
+  QSet<GamebryoPluginName> m_PrimaryPluginsIndex;
+
+  CreationPluginSlots m_Slots;
+  bool m_SlotsOrderDirty;
+  bool m_SlotsExceeded;
 };
 
 #endif  // CREATIONGAMEPLUGINS_H
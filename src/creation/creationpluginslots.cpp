@@ -0,0 +1,158 @@
+#include "creationpluginslots.h"
+
+namespace
+{
+
+// the last index is reserved for runtime created forms, the one before for light
+// plugins and, if supported, the one before that for medium plugins
+constexpr uint32_t LIGHT_INDEX  = 0xFE;
+constexpr uint32_t MEDIUM_INDEX = 0xFD;
+
+constexpr int LIGHT_SLOTS  = 0x1000;
+constexpr int MEDIUM_SLOTS = 0x100;
+
+}  // namespace
+
+CreationPluginSlots::CreationPluginSlots(bool mediumPluginsSupported)
+    : m_MediumPluginsSupported(mediumPluginsSupported), m_RangesDirty(true)
+{}
+
+void CreationPluginSlots::setMediumPluginsSupported(bool supported)
+{
+  if (m_MediumPluginsSupported != supported) {
+    m_MediumPluginsSupported = supported;
+    m_RangesDirty            = true;
+  }
+}
+
+CreationPluginSlots::Usage CreationPluginSlots::limits() const
+{
+  Usage result;
+  result.full   = m_MediumPluginsSupported ? MEDIUM_INDEX : LIGHT_INDEX;
+  result.medium = m_MediumPluginsSupported ? MEDIUM_SLOTS : 0;
+  result.light  = LIGHT_SLOTS;
+  return result;
+}
+
+bool CreationPluginSlots::exceedsLimits() const
+{
+  const Usage max = limits();
+  return m_Usage.full > max.full || m_Usage.medium > max.medium ||
+         m_Usage.light > max.light;
+}
+
+void CreationPluginSlots::clear()
+{
+  m_Usage = {};
+  m_Plugins.clear();
+  m_LoadOrder.clear();
+  m_RangesDirty = true;
+}
+
+int& CreationPluginSlots::count(Type type)
+{
+  switch (type) {
+  case Type::Medium:
+    return m_Usage.medium;
+  case Type::Light:
+    return m_Usage.light;
+  default:
+    return m_Usage.full;
+  }
+}
+
+void CreationPluginSlots::setPlugin(const QString& pluginName, Type type, bool active)
+{
+  Plugin& plugin = m_Plugins[pluginName];
+  if (plugin.active) {
+    --count(plugin.type);
+  }
+
+  plugin = {type, active};
+  if (active) {
+    ++count(type);
+  }
+
+  m_RangesDirty = true;
+}
+
+void CreationPluginSlots::setActive(const QString& pluginName, bool active)
+{
+  auto it = m_Plugins.find(pluginName);
+  if (it == m_Plugins.end() || it->active == active) {
+    return;
+  }
+
+  it->active = active;
+  count(it->type) += active ? 1 : -1;
+
+  m_RangesDirty = true;
+}
+
+void CreationPluginSlots::setLoadOrder(const QStringList& loadOrder)
+{
+  m_LoadOrder = loadOrder;
+
+  m_RangesDirty = true;
+}
+
+std::optional<CreationPluginSlots::Range>
+CreationPluginSlots::formIdRange(const QString& pluginName) const
+{
+  if (m_RangesDirty) {
+    updateRanges();
+  }
+
+  auto it = m_Ranges.constFind(pluginName);
+  if (it == m_Ranges.constEnd()) {
+    return {};
+  }
+
+  return *it;
+}
+
+void CreationPluginSlots::updateRanges() const
+{
+  const Usage max = limits();
+  Usage next;
+
+  m_Ranges.clear();
+  m_Ranges.reserve(m_Usage.full + m_Usage.medium + m_Usage.light);
+
+  for (const QString& pluginName : m_LoadOrder) {
+    auto it = m_Plugins.constFind(pluginName);
+    if (it == m_Plugins.constEnd() || !it->active) {
+      continue;
+    }
+
+    switch (it->type) {
+    case Type::Full: {
+      if (next.full < max.full) {
+        const uint32_t first = static_cast<uint32_t>(next.full) << 24;
+        m_Ranges.insert(pluginName, {first, first | 0xFFFFFF});
+      }
+      ++next.full;
+    } break;
+
+    case Type::Medium: {
+      if (next.medium < max.medium) {
+        const uint32_t first =
+            (MEDIUM_INDEX << 24) | (static_cast<uint32_t>(next.medium) << 16);
+        m_Ranges.insert(pluginName, {first, first | 0xFFFF});
+      }
+      ++next.medium;
+    } break;
+
+    case Type::Light: {
+      if (next.light < max.light) {
+        const uint32_t first =
+            (LIGHT_INDEX << 24) | (static_cast<uint32_t>(next.light) << 12);
+        m_Ranges.insert(pluginName, {first, first | 0xFFF});
+      }
+      ++next.light;
+    } break;
+    }
+  }
+
+  m_RangesDirty = false;
+}
@@ -0,0 +1,113 @@
+#ifndef CREATIONPLUGINSLOTS_H
+#define CREATIONPLUGINSLOTS_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <gamebryopluginname.h>
+
+#include <cstdint>
+#include <optional>
+
+/**
+ * @brief Keeps track of how many full, medium and light plugins are active and which
+ * FormID range each of them gets in game.
+ *
+ * Counts are updated incrementally as plugins change state, FormID ranges are only
+ * recomputed when requested after a change.
+ */
+class CreationPluginSlots
+{
+public:
+  enum class Type
+  {
+    Full,
+    Medium,
+    Light
+  };
+
+  struct Usage
+  {
+    int full   = 0;
+    int medium = 0;
+    int light  = 0;
+  };
+
+  struct Range
+  {
+    uint32_t first;
+    uint32_t last;
+  };
+
+  /**
+   * @param mediumPluginsSupported whether the game supports medium plugins, which
+   * take one of the full plugin slots
+   */
+  CreationPluginSlots(bool mediumPluginsSupported = false);
+
+  void setMediumPluginsSupported(bool supported);
+
+  /**
+   * @return the maximum number of active plugins of each type
+   */
+  Usage limits() const;
+
+  /**
+   * @return the number of active plugins of each type
+   */
+  Usage usage() const { return m_Usage; }
+
+  /**
+   * @return true if more plugins of some type are active than the game can load
+   */
+  bool exceedsLimits() const;
+
+  /**
+   * @brief Removes all plugins.
+   */
+  void clear();
+
+  /**
+   * @brief Adds a plugin or updates its type and state.
+   */
+  void setPlugin(const QString& pluginName, Type type, bool active);
+
+  /**
+   * @brief Updates the state of a known plugin.
+   */
+  void setActive(const QString& pluginName, bool active);
+
+  /**
+   * @brief Sets the order in which plugins are loaded, which determines their FormID
+   * range.
+   */
+  void setLoadOrder(const QStringList& loadOrder);
+
+  /**
+   * @return the range of FormIDs of the given plugin, or nothing if the plugin is not
+   * active or does not fit in the available slots
+   */
+  std::optional<Range> formIdRange(const QString& pluginName) const;
+
+private:
+  struct Plugin
+  {
+    Type type;
+    bool active;
+  };
+
+  int& count(Type type);
+  void updateRanges() const;
+
+private:
+  bool m_MediumPluginsSupported;
+  Usage m_Usage;
+
+  QHash<GamebryoPluginName, Plugin> m_Plugins;
+  QStringList m_LoadOrder;
+
+  mutable bool m_RangesDirty;
+  mutable QHash<GamebryoPluginName, Range> m_Ranges;
+};
+
+#endif  // CREATIONPLUGINSLOTS_H
@@ -0,0 +1,280 @@
+#include "bsahash.h"
+#include "gamebryowindows1252.h"
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#ifdef __unix__
+static inline constexpr int MAX_PATH = 1024;
+#else
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GAMEBRYO_BSAHASH_SSE2
+#endif
+
+namespace
+{
+
+// extensions that set extra bits in the hash of a file name
+struct ExtensionClass
+{
+  uint32_t packed;
+  qsizetype length;
+  uint64_t bits;
+};
+
+constexpr uint32_t packExtension(const char* extension, qsizetype length)
+{
+  uint32_t packed = 0;
+  for (qsizetype i = 0; i < length; ++i) {
+    const auto c = static_cast<unsigned char>(extension[i]);
+    packed |= static_cast<uint32_t>(c) << (8 * i);
+  }
+  return packed;
+}
+
+constexpr ExtensionClass EXTENSION_CLASSES[] = {
+    {packExtension("kf", 2), 2, 0x80},
+    {packExtension("nif", 3), 3, 0x8000},
+    {packExtension("dds", 3), 3, 0x8080},
+    {packExtension("wav", 3), 3, 0x80000000}};
+
+// paths are hashed up to MAX_PATH characters
+using PathBuffer = std::array<char, MAX_PATH>;
+
+uint32_t hashRange(const char* path, qsizetype begin, qsizetype end)
+{
+  uint32_t hash = 0;
+  for (qsizetype i = begin; i < end; ++i) {
+    hash = hash * 0x1003f + static_cast<unsigned char>(path[i]);
+  }
+  return hash;
+}
+
+// lowercases a path into buffer and turns both kinds of slashes into separator, in
+// the same pass that finds its end and its last dot
+qsizetype normalizePath(QByteArrayView path, char separator, PathBuffer& buffer,
+                        qsizetype& lastDot)
+{
+  const qsizetype size = std::min<qsizetype>(path.size(), MAX_PATH);
+  const char* source   = path.data();
+  char* target         = buffer.data();
+
+  lastDot     = -1;
+  qsizetype i = 0;
+
+#ifdef GAMEBRYO_BSAHASH_SSE2
+  for (; i + 16 <= size; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+
+    const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                        _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+    v = _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+
+    const __m128i slash = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\')),
+                                       _mm_cmpeq_epi8(v, _mm_set1_epi8('/')));
+    v = _mm_or_si128(_mm_andnot_si128(slash, v),
+                     _mm_and_si128(slash, _mm_set1_epi8(separator)));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), v);
+
+    auto dots = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('.'))));
+    const auto nulls = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())));
+
+    // only the part up to the first null character counts
+    if (nulls != 0) {
+      const int end = std::countr_zero(nulls);
+      dots &= (1u << end) - 1;
+      if (dots != 0) {
+        lastDot = i + std::bit_width(dots) - 1;
+      }
+      return i + end;
+    }
+
+    if (dots != 0) {
+      lastDot = i + std::bit_width(dots) - 1;
+    }
+  }
+#endif
+
+  for (; i < size; ++i) {
+    char c = source[i];
+    if (c == '\0') {
+      break;
+    }
+
+    if (c >= 'A' && c <= 'Z') {
+      c = static_cast<char>(c | 0x20);
+    } else if (c == '\\' || c == '/') {
+      c = separator;
+    } else if (c == '.') {
+      lastDot = i;
+    }
+
+    target[i] = c;
+  }
+
+  return i;
+}
+
+uint64_t hashPath(const char* path, qsizetype size, qsizetype lastDot,
+                  bool splitExtension)
+{
+  // folders have no extension, files without a dot have an empty one
+  const qsizetype length = (splitExtension && lastDot >= 0) ? lastDot : size;
+
+  uint64_t hash = 0;
+
+  if (length > 0) {
+    // these bits used to be computed as an int from plain chars, so they sign-extend
+    // the same way here, archives rely on the exact values
+    const int beforeLast = length > 2 ? path[length - 2] : 0;
+    const uint32_t last  = static_cast<unsigned char>(path[length - 1]);
+    const uint32_t first = static_cast<unsigned char>(path[0]);
+    const uint32_t low   = last | (static_cast<uint32_t>(beforeLast) << 8) |
+                         (static_cast<uint32_t>(length) << 16) | (first << 24);
+    hash = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(low)));
+  }
+
+  if (length < size) {
+    const char* extension         = path + length + 1;
+    const qsizetype extensionSize = size - length - 1;
+    if (extensionSize <= 3) {
+      const uint32_t packed = packExtension(extension, extensionSize);
+      for (const auto& extensionClass : EXTENSION_CLASSES) {
+        if (extensionClass.length == extensionSize && extensionClass.packed == packed) {
+          hash |= extensionClass.bits;
+          break;
+        }
+      }
+    }
+
+    uint64_t temp = hashRange(path, 1, length - 2);
+    temp += hashRange(path, length, size);
+
+    hash |= (temp & 0xFFFFFFFF) << 32;
+  } else if (!splitExtension) {
+    // the middle of folder names is hashed even though they have no extension
+    const uint64_t temp = hashRange(path, 1, size - 2);
+    hash |= (temp & 0xFFFFFFFF) << 32;
+  }
+
+  return hash;
+}
+
+void hashPaths(std::span<const QByteArrayView> paths, std::span<uint64_t> hashes,
+               bool folders)
+{
+  Q_ASSERT(hashes.size() >= paths.size());
+
+  const char separator = folders ? '\\' : '/';
+
+  PathBuffer buffer;
+  for (std::size_t i = 0; i < paths.size(); ++i) {
+    qsizetype lastDot;
+    const qsizetype size = normalizePath(paths[i], separator, buffer, lastDot);
+    hashes[i]            = hashPath(buffer.data(), size, lastDot, !folders);
+  }
+}
+
+char normalizePathChar(char c)
+{
+  if (c == '/') {
+    return '\\';
+  }
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+}
+
+constexpr std::array<uint32_t, 256> makeCrc32Table()
+{
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+    }
+    table[i] = crc;
+  }
+  return table;
+}
+
+constexpr std::array<uint32_t, 256> CRC32_TABLE = makeCrc32Table();
+
+}  // namespace
+
+uint64_t bsaFileHash(QByteArrayView fileName)
+{
+  uint64_t hash;
+  hashPaths({&fileName, 1}, {&hash, 1}, false);
+  return hash;
+}
+
+uint64_t bsaFolderHash(QByteArrayView folderName)
+{
+  uint64_t hash;
+  hashPaths({&folderName, 1}, {&hash, 1}, true);
+  return hash;
+}
+
+void bsaFileHashes(std::span<const QByteArrayView> fileNames,
+                   std::span<uint64_t> hashes)
+{
+  hashPaths(fileNames, hashes, false);
+}
+
+void bsaFolderHashes(std::span<const QByteArrayView> folderNames,
+                     std::span<uint64_t> hashes)
+{
+  hashPaths(folderNames, hashes, true);
+}
+
+uint32_t ba2Hash(QByteArrayView name)
+{
+  uint32_t hash = 0;
+  for (char c : name) {
+    const auto byte = static_cast<unsigned char>(normalizePathChar(c));
+    hash            = (hash >> 8) ^ CRC32_TABLE[(hash ^ byte) & 0xff];
+  }
+  return hash;
+}
+
+bool bsaPathEquals(QByteArrayView lhs, QByteArrayView rhs)
+{
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+
+  for (qsizetype i = 0; i < lhs.size(); ++i) {
+    if (normalizePathChar(lhs[i]) != normalizePathChar(rhs[i])) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void bsaNormalizePath(char* path, qsizetype size)
+{
+  for (qsizetype i = 0; i < size; ++i) {
+    path[i] = normalizePathChar(path[i]);
+  }
+}
+
+QString bsaPathToString(QByteArrayView path)
+{
+  return decodeWindows1252(path);
+}
+
+QByteArray bsaPathFromString(QStringView path)
+{
+  return encodeWindows1252(path).value_or(QByteArray());
+}
@@ -0,0 +1,87 @@
+#ifndef BSAHASH_H
+#define BSAHASH_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QStringView>
+
+#include <cstdint>
+#include <span>
+
+/**
+ * @brief Computes the hash of a file name as stored in BSA archives.
+ *
+ * The name is lowercased and backslashes are turned into slashes. The extension is
+ * hashed separately and well-known extensions set extra bits. Only the part up to
+ * the first null character is hashed.
+ *
+ * @param fileName name of the file, without its folder
+ **/
+uint64_t bsaFileHash(QByteArrayView fileName);
+
+/**
+ * @brief Computes the hash of a folder name as stored in BSA archives. Same as
+ * bsaFileHash() except that dots in the name do not start an extension and slashes
+ * are turned into backslashes.
+ *
+ * @param folderName path of the folder, relative to the data directory
+ **/
+uint64_t bsaFolderHash(QByteArrayView folderName);
+
+/**
+ * @brief Computes the hashes of many file names at once, same as calling bsaFileHash()
+ * for each of them. Meant for indexing archives, where the per-call overhead adds up.
+ *
+ * @param fileNames names of the files, without their folders
+ * @param hashes receives the hash of each name, must be at least as large as fileNames
+ **/
+void bsaFileHashes(std::span<const QByteArrayView> fileNames,
+                   std::span<uint64_t> hashes);
+
+/**
+ * @brief Computes the hashes of many folder names at once, same as calling
+ * bsaFolderHash() for each of them.
+ *
+ * @param folderNames paths of the folders, relative to the data directory
+ * @param hashes receives the hash of each path, must be at least as large as
+ * folderNames
+ **/
+void bsaFolderHashes(std::span<const QByteArrayView> folderNames,
+                     std::span<uint64_t> hashes);
+
+/**
+ * @brief Computes the hash of a name as stored in BA2 archives, a CRC32 without the
+ * usual pre- and post-inversion of the lowercased name with backslashes.
+ *
+ * @param name folder path, or file name without its extension
+ **/
+uint32_t ba2Hash(QByteArrayView name);
+
+/**
+ * @brief Compares two paths inside of an archive case-insensitively, with slashes and
+ * backslashes being equal.
+ **/
+bool bsaPathEquals(QByteArrayView lhs, QByteArrayView rhs);
+
+/**
+ * @brief Lowercases a path inside of an archive and turns its slashes into
+ * backslashes, in place, so that paths that are equal for bsaPathEquals() become
+ * identical.
+ **/
+void bsaNormalizePath(char* path, qsizetype size);
+
+/**
+ * @brief Decodes a path inside of an archive. The games store them in Windows-1252,
+ * which is decoded the same way on every system, unlike the local 8-bit encoding.
+ **/
+QString bsaPathToString(QByteArrayView path);
+
+/**
+ * @brief Encodes a path in Windows-1252 to look it up in an archive, the reverse of
+ * bsaPathToString(). A path that cannot be encoded is returned empty, which no archive
+ * path is.
+ **/
+QByteArray bsaPathFromString(QStringView path);
+
+#endif  // BSAHASH_H
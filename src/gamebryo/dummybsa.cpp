@@ -18,13 +18,13 @@ along with Mod Organizer.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "dummybsa.h"
-#include <QFile>
-#ifdef __unix__
-static inline constexpr int MAX_PATH = 1024;
-#else
-#define WIN32_LEAN_AND_MEAN
-#include <Windows.h>
-#endif
+#include "bsahash.h"
+
+#include <QSaveFile>
+
+#include <cstring>
+#include <map>
+#include <mutex>
 
 static void writeUlong(unsigned char* buffer, int offset, uint32_t value)
 {
@@ -48,70 +48,12 @@ static void writeUlonglong(unsigned char* buffer, int offset, uint64_t value)
   memcpy(buffer + offset, cValue, 8);
 }
 
-static uint32_t genHashInt(const unsigned char* pos, const unsigned char* end)
-{
-  uint32_t hash = 0;
-  for (; pos < end; ++pos) {
-    hash *= 0x1003f;
-    hash += *pos;
-  }
-  return hash;
-}
-
-static uint64_t genHash(const char* fileName)
-{
-  char fileNameLower[MAX_PATH + 1];
-  int i = 0;
-  for (; i < MAX_PATH && fileName[i] != '\0'; ++i) {
-    fileNameLower[i] = static_cast<char>(tolower(fileName[i]));
-    if (fileNameLower[i] == '\\') {
-      fileNameLower[i] = '/';
-    }
-  }
-  fileNameLower[i] = '\0';
-
-  unsigned char* fileNameLowerU = reinterpret_cast<unsigned char*>(fileNameLower);
-
-  char* ext = strrchr(fileNameLower, '.');
-  if (ext == nullptr) {
-    ext = fileNameLower + strlen(fileNameLower);
-  }
-  unsigned char* extU = reinterpret_cast<unsigned char*>(ext);
-
-  int length = ext - fileNameLower;
-
-  uint64_t hash = 0ULL;
-
-  if (length > 0) {
-    hash = *(extU - 1) | ((length > 2 ? *(ext - 2) : 0) << 8) | (length << 16) |
-           (fileNameLowerU[0] << 24);
-  }
-
-  if (strlen(ext) > 0) {
-    if (strcmp(ext + 1, "kf") == 0) {
-      hash |= 0x80;
-    } else if (strcmp(ext + 1, "nif") == 0) {
-      hash |= 0x8000;
-    } else if (strcmp(ext + 1, "dds") == 0) {
-      hash |= 0x8080;
-    } else if (strcmp(ext + 1, "wav") == 0) {
-      hash |= 0x80000000;
-    }
-
-    uint64_t temp = static_cast<uint64_t>(genHashInt(fileNameLowerU + 1, extU - 2));
-    temp += static_cast<uint64_t>(genHashInt(extU, extU + strlen(ext)));
-
-    hash |= (temp & 0xFFFFFFFF) << 32;
-  }
-  return hash;
-}
-
 DummyBSA::DummyBSA(uint32_t bsaVersion)
     : m_Version(bsaVersion), m_FolderName(""), m_FileName("dummy.dds"),
       m_TotalFileNameLength(0)
 {}
 
-void DummyBSA::writeHeader(QFile& file)
+void DummyBSA::writeHeader(QByteArray& data)
 {
   unsigned char header[] = {
       'B',  'S',  'A',  '\0',  // magic string
@@ -133,10 +75,10 @@ void DummyBSA::writeHeader(QFile& file)
 
   writeUlong(header, 32, 2);  // has dds
 
-  file.write(reinterpret_cast<char*>(header), sizeof(header));
+  data.append(reinterpret_cast<char*>(header), sizeof(header));
 }
 
-void DummyBSA::writeFolderRecord(QFile& file, const std::string& folderName)
+void DummyBSA::writeFolderRecord(QByteArray& data, const std::string& folderName)
 {
   unsigned char folderRecord[] = {
       0xDE, 0xAD, 0xBE, 0xEF, 0xDE, 0xAD, 0xBE, 0xEF,  // folder hash
@@ -144,14 +86,14 @@ void DummyBSA::writeFolderRecord(QFile& file, const std::string& folderName)
       0xDE, 0xAD, 0xBE, 0xEF,                          // offset to folder name
   };
   // we'd usually have to sort folders be the hash value generated here
-  writeUlonglong(folderRecord, 0, genHash(folderName.c_str()));
+  writeUlonglong(folderRecord, 0, bsaFolderHash(folderName));
   writeUlong(folderRecord, 12,
              0x34 + m_TotalFileNameLength);  // TODO: this should be calculated properly
 
-  file.write(reinterpret_cast<char*>(folderRecord), sizeof(folderRecord));
+  data.append(reinterpret_cast<char*>(folderRecord), sizeof(folderRecord));
 }
 
-void DummyBSA::writeFileRecord(QFile& file, const std::string& fileName)
+void DummyBSA::writeFileRecord(QByteArray& data, const std::string& fileName)
 {
   unsigned char fileRecord[] = {
       0xDE, 0xAD, 0xBE, 0xEF, 0xDE, 0xAD, 0xBE, 0xEF,  // file name hash
@@ -160,35 +102,73 @@ void DummyBSA::writeFileRecord(QFile& file, const std::string& fileName)
   };
 
   // we'd usually have to sort files by the value generated here
-  writeUlonglong(fileRecord, 0, genHash(fileName.c_str()));
+  writeUlonglong(fileRecord, 0, bsaFileHash(fileName));
   writeUlong(fileRecord, 8, 0);
   writeUlong(
       fileRecord, 12,
       0x44 + static_cast<uint32_t>(fileName.length() + 1) +
           4);  // after this record we expect the filename and 4 bytes of file size
 
-  file.write(reinterpret_cast<char*>(fileRecord), sizeof(fileRecord));
+  data.append(reinterpret_cast<char*>(fileRecord), sizeof(fileRecord));
 }
 
-void DummyBSA::writeFileRecordBlocks(QFile& file, const std::string& folderName)
+void DummyBSA::writeFileRecordBlocks(QByteArray& data, const std::string& folderName)
 {
-  file.write(folderName.c_str(), folderName.length() + 1);
+  data.append(folderName.c_str(), folderName.length() + 1);
 
-  writeFileRecord(file, m_FileName);
+  writeFileRecord(data, m_FileName);
 }
 
-void DummyBSA::write(const QString& fileName)
+QByteArray DummyBSA::build()
 {
-  QFile file(fileName);
-  file.open(QIODevice::WriteOnly);
+  QByteArray data;
 
   m_TotalFileNameLength = static_cast<uint32_t>(m_FileName.length() + 1);
 
-  writeHeader(file);
-  writeFolderRecord(file, m_FolderName);
-  writeFileRecordBlocks(file, m_FolderName);
-  file.write(m_FileName.c_str(), m_FileName.length() + 1);
+  writeHeader(data);
+  writeFolderRecord(data, m_FolderName);
+  writeFileRecordBlocks(data, m_FolderName);
+  data.append(m_FileName.c_str(), m_FileName.length() + 1);
   char fileSize[] = {0x00, 0x00, 0x00, 0x00};
-  file.write(fileSize, sizeof(fileSize));
-  file.close();
+  data.append(fileSize, sizeof(fileSize));
+
+  return data;
+}
+
+QByteArray DummyBSA::data()
+{
+  // the archive only depends on the version, so it is built once per version
+  static std::mutex mutex;
+  static std::map<uint32_t, QByteArray> templates;
+
+  std::scoped_lock lock(mutex);
+
+  auto it = templates.find(m_Version);
+  if (it == templates.end()) {
+    it = templates.emplace(m_Version, build()).first;
+  }
+
+  return it->second;
+}
+
+bool DummyBSA::write(const QString& fileName)
+{
+  const QByteArray bytes = data();
+
+  // written to a temporary file first, so a failed write never leaves a broken
+  // archive in the data directory
+  QSaveFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly)) {
+    qWarning("failed to open \"%s\": %s", qUtf8Printable(fileName),
+             qUtf8Printable(file.errorString()));
+    return false;
+  }
+
+  if (file.write(bytes) != bytes.size() || !file.commit()) {
+    qWarning("failed to write \"%s\": %s", qUtf8Printable(fileName),
+             qUtf8Printable(file.errorString()));
+    return false;
+  }
+
+  return true;
 }
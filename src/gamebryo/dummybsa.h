@@ -20,9 +20,11 @@ along with Mod Organizer.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef DUMMYBSA_H
 #define DUMMYBSA_H
 
-#include <QFile>
+#include <QByteArray>
 #include <QString>
 
+#include <string>
+
 /**
  * @brief Class for creating a dummy bsa used for archive invalidation
  **/
@@ -37,17 +39,25 @@ public:
   DummyBSA(uint32_t bsaVersion);
 
   /**
-   * @brief write to the specified file
+   * @brief write to the specified file, replacing it atomically
    *
    * @param fileName name of the file to write to
+   * @return true if the file was written
    **/
-  void write(const QString& fileName);
+  bool write(const QString& fileName);
+
+  /**
+   * @return the content of the archive, built once per version and shared afterwards
+   **/
+  QByteArray data();
 
 private:
-  void writeHeader(QFile& file);
-  void writeFolderRecord(QFile& file, const std::string& folderName);
-  void writeFileRecord(QFile& file, const std::string& fileName);
-  void writeFileRecordBlocks(QFile& file, const std::string& folderName);
+  QByteArray build();
+
+  void writeHeader(QByteArray& data);
+  void writeFolderRecord(QByteArray& data, const std::string& folderName);
+  void writeFileRecord(QByteArray& data, const std::string& fileName);
+  void writeFileRecordBlocks(QByteArray& data, const std::string& folderName);
 
 private:
   uint32_t m_Version;
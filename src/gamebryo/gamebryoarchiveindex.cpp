@@ -0,0 +1,362 @@
+#include "gamebryoarchiveindex.h"
+
+#include "bsahash.h"
+#include "gamebryoba2archive.h"
+#include "gamebryobsaarchive.h"
+#include "gamebryoparallel.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSet>
+#include <dataarchives.h>
+#include <igamefeatures.h>
+#include <imodinterface.h>
+#include <imodlist.h>
+#include <imoinfo.h>
+#include <iplugingame.h>
+
+#include <algorithm>
+#include <exception>
+#include <map>
+
+using namespace MOBase;
+
+namespace
+{
+
+std::size_t pathKey(QByteArrayView normalizedPath)
+{
+  return qHash(normalizedPath, 0);
+}
+
+}  // namespace
+
+GamebryoArchiveIndex::GamebryoArchiveIndex(IOrganizer* organizer)
+    : m_Organizer(organizer), m_Dirty(std::make_shared<bool>(true))
+{
+  const auto setDirty = [dirty = std::weak_ptr<bool>(m_Dirty)] {
+    if (const auto flag = dirty.lock()) {
+      *flag = true;
+    }
+  };
+
+  m_Organizer->onProfileChanged([setDirty](IProfile*, IProfile*) {
+    setDirty();
+  });
+
+  IModList* modList = m_Organizer->modList();
+  if (modList == nullptr) {
+    return;
+  }
+
+  modList->onModInstalled([setDirty](IModInterface*) {
+    setDirty();
+  });
+
+  modList->onModRemoved([setDirty](const QString&) {
+    setDirty();
+  });
+
+  modList->onModMoved([setDirty](const QString&, int, int) {
+    setDirty();
+  });
+
+  modList->onModStateChanged([setDirty](const std::map<QString, IModList::ModStates>&) {
+    setDirty();
+  });
+}
+
+QStringList GamebryoArchiveIndex::archivePaths() const
+{
+  QStringList result;
+  QSet<QString> seen;
+
+  // an archive can show up twice, for example when a mod points to the data directory
+  const auto add = [&](const QString& path) {
+    const QString key = QDir::cleanPath(path).toLower();
+    if (!seen.contains(key)) {
+      seen.insert(key);
+      result.append(path);
+    }
+  };
+
+  const IPluginGame* game = m_Organizer->managedGame();
+  auto dataArchives       = m_Organizer->gameFeatures()->gameFeature<DataArchives>();
+  if (game != nullptr && dataArchives != nullptr) {
+    const QDir dataDirectory = game->dataDirectory();
+    for (const QString& archive : dataArchives->archives(m_Organizer->profile())) {
+      const QString path = dataDirectory.absoluteFilePath(archive);
+      if (QFileInfo::exists(path)) {
+        add(path);
+      }
+    }
+  }
+
+  IModList* modList = m_Organizer->modList();
+  if (modList == nullptr) {
+    return result;
+  }
+
+  for (const QString& modName : modList->allModsByProfilePriority()) {
+    if (!modList->state(modName).testFlag(IModList::STATE_ACTIVE)) {
+      continue;
+    }
+
+    const IModInterface* mod = modList->getMod(modName);
+    if (mod == nullptr) {
+      continue;
+    }
+
+    const QDir modDirectory(mod->absolutePath());
+    for (const QString& archive :
+         modDirectory.entryList({"*.bsa", "*.ba2"}, QDir::Files,
+                                QDir::Name | QDir::IgnoreCase)) {
+      add(modDirectory.absoluteFilePath(archive));
+    }
+  }
+
+  return result;
+}
+
+void GamebryoArchiveIndex::readArchive(Archive& archive)
+{
+  archive.names.clear();
+  archive.nameOffsets.clear();
+  archive.keys.clear();
+
+  const auto addName = [&archive](QByteArrayView folder, QByteArrayView file) {
+    const qsizetype start = archive.names.size();
+    if (!folder.isEmpty()) {
+      archive.names.append(folder);
+      archive.names.append('\\');
+    }
+    archive.names.append(file);
+
+    bsaNormalizePath(archive.names.data() + start, archive.names.size() - start);
+    archive.nameOffsets.push_back(static_cast<uint32_t>(archive.names.size()));
+  };
+
+  archive.nameOffsets.push_back(0);
+
+  try {
+    if (archive.path.endsWith(".ba2", Qt::CaseInsensitive)) {
+      GamebryoBA2Archive ba2;
+      ba2.open(archive.path);
+      for (const auto& file : ba2.files()) {
+        if (!file.name.isEmpty()) {
+          addName({}, file.name);
+        }
+      }
+    } else {
+      GamebryoBSAArchive bsa;
+      bsa.open(archive.path);
+      for (const auto& file : bsa.files()) {
+        if (!file.name.isEmpty()) {
+          addName(bsa.folders()[file.folder].name, file.name);
+        }
+      }
+    }
+  } catch (const std::exception& e) {
+    // the archive stays empty until it changes on disk
+    qWarning("failed to index archive: %s", e.what());
+    archive.names.clear();
+    archive.nameOffsets.assign(1, 0);
+  }
+
+  const auto count = static_cast<uint32_t>(archive.nameOffsets.size() - 1);
+  archive.keys.reserve(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    archive.keys.push_back(pathKey(archive.name(i)));
+  }
+}
+
+void GamebryoArchiveIndex::addEntries(uint32_t id)
+{
+  Archive& archive = m_Archives[id];
+  for (uint32_t i = 0; i < archive.keys.size(); ++i) {
+    m_Entries[archive.keys[i]].append({id, i});
+  }
+  archive.active = true;
+}
+
+void GamebryoArchiveIndex::removeEntries(uint32_t id)
+{
+  Archive& archive = m_Archives[id];
+  for (const std::size_t key : archive.keys) {
+    auto it = m_Entries.find(key);
+    if (it == m_Entries.end()) {
+      continue;
+    }
+
+    Providers& providers = *it;
+    providers.removeIf([id](const Provider& provider) {
+      return provider.archive == id;
+    });
+
+    if (providers.isEmpty()) {
+      m_Entries.erase(it);
+    }
+  }
+  archive.active = false;
+}
+
+void GamebryoArchiveIndex::refresh()
+{
+  const QStringList paths = archivePaths();
+
+  std::vector<int> priorities(m_Archives.size(), -1);
+  std::vector<uint32_t> toRead;
+
+  for (int priority = 0; priority < paths.size(); ++priority) {
+    const QString& path = paths[priority];
+
+    auto it = m_ArchiveIds.constFind(path);
+    if (it == m_ArchiveIds.constEnd()) {
+      it = m_ArchiveIds.insert(path, static_cast<uint32_t>(m_Archives.size()));
+      m_Archives.push_back({});
+      m_Archives.back().path = path;
+      priorities.push_back(-1);
+    }
+
+    const uint32_t id = *it;
+    Archive& archive  = m_Archives[id];
+    priorities[id]    = priority;
+
+    const QFileInfo info(path);
+    if (archive.size != info.size() || archive.lastModified != info.lastModified()) {
+      if (archive.active) {
+        removeEntries(id);
+      }
+      archive.size         = info.size();
+      archive.lastModified = info.lastModified();
+      toRead.push_back(id);
+    }
+  }
+
+  // archives of mods that were disabled
+  for (uint32_t id = 0; id < m_Archives.size(); ++id) {
+    if (priorities[id] < 0 && m_Archives[id].active) {
+      removeEntries(id);
+    }
+    m_Archives[id].priority = priorities[id];
+  }
+
+  parallelFor(toRead.size(), [&](std::size_t i) {
+    readArchive(m_Archives[toRead[i]]);
+  });
+
+  for (uint32_t id = 0; id < m_Archives.size(); ++id) {
+    if (m_Archives[id].priority >= 0 && !m_Archives[id].active) {
+      addEntries(id);
+    }
+  }
+
+  *m_Dirty = false;
+}
+
+void GamebryoArchiveIndex::refreshIfDirty()
+{
+  if (*m_Dirty) {
+    refresh();
+  }
+}
+
+void GamebryoArchiveIndex::sortByPriority(Providers& providers) const
+{
+  std::sort(providers.begin(), providers.end(),
+            [this](const Provider& lhs, const Provider& rhs) {
+              return m_Archives[lhs.archive].priority <
+                     m_Archives[rhs.archive].priority;
+            });
+}
+
+QStringList GamebryoArchiveIndex::archives()
+{
+  refreshIfDirty();
+
+  std::vector<const Archive*> active;
+  for (const Archive& archive : m_Archives) {
+    if (archive.active) {
+      active.push_back(&archive);
+    }
+  }
+
+  std::sort(active.begin(), active.end(), [](const Archive* lhs, const Archive* rhs) {
+    return lhs->priority < rhs->priority;
+  });
+
+  QStringList result;
+  result.reserve(active.size());
+  for (const Archive* archive : active) {
+    result.append(archive->path);
+  }
+
+  return result;
+}
+
+QStringList GamebryoArchiveIndex::providers(const QString& filePath)
+{
+  refreshIfDirty();
+
+  QByteArray path = bsaPathFromString(filePath);
+  bsaNormalizePath(path.data(), path.size());
+
+  auto it = m_Entries.constFind(pathKey(path));
+  if (it == m_Entries.constEnd()) {
+    return {};
+  }
+
+  Providers providers = *it;
+  sortByPriority(providers);
+
+  QStringList result;
+  for (const Provider& provider : providers) {
+    const Archive& archive = m_Archives[provider.archive];
+    if (archive.name(provider.entry) == path) {
+      result.append(archive.path);
+    }
+  }
+
+  return result;
+}
+
+std::vector<GamebryoArchiveIndex::Conflict> GamebryoArchiveIndex::conflicts()
+{
+  refreshIfDirty();
+
+  std::vector<Conflict> result;
+
+  for (auto it = m_Entries.cbegin(); it != m_Entries.cend(); ++it) {
+    if (it->size() < 2) {
+      continue;
+    }
+
+    Providers providers = *it;
+    sortByPriority(providers);
+
+    // hashes of different paths can collide, so the providers are grouped by their
+    // path and each path with more than one archive is a conflict
+    QVarLengthArray<std::pair<QByteArrayView, QStringList>, 1> paths;
+    for (const Provider& provider : providers) {
+      const Archive& archive    = m_Archives[provider.archive];
+      const QByteArrayView name = archive.name(provider.entry);
+
+      auto group = std::find_if(paths.begin(), paths.end(), [&](const auto& path) {
+        return path.first == name;
+      });
+      if (group == paths.end()) {
+        paths.append({name, {}});
+        group = paths.end() - 1;
+      }
+      group->second.append(archive.path);
+    }
+
+    for (auto& [path, archives] : paths) {
+      if (archives.size() > 1) {
+        result.push_back({bsaPathToString(path), std::move(archives)});
+      }
+    }
+  }
+
+  return result;
+}
@@ -0,0 +1,137 @@
+#ifndef GAMEBRYOARCHIVEINDEX_H
+#define GAMEBRYOARCHIVEINDEX_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVarLengthArray>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace MOBase
+{
+class IOrganizer;
+}
+
+/**
+ * @brief Index of the content of every BSA and BA2 archive of the current setup, to
+ * find which archives provide an asset and which assets are provided by more than one
+ * archive.
+ *
+ * Archives are the ones listed in the game INI files for the current profile, followed
+ * by the archives of the enabled mods in mod priority order. Each archive is read once
+ * and only read again when it changes on disk. Enabling, disabling or moving mods only
+ * adds, removes or reorders the entries of their archives.
+ *
+ * Not thread-safe, meant to be used from the thread the organizer calls back on. The
+ * callbacks registered on the organizer can outlive the index, they do nothing once it
+ * is destroyed.
+ */
+class GamebryoArchiveIndex
+{
+public:
+  struct Conflict
+  {
+    // path of the asset, lowercase with backslashes
+    QString path;
+
+    // archives that provide the asset, by increasing priority, the last one wins
+    QStringList archives;
+  };
+
+  GamebryoArchiveIndex(MOBase::IOrganizer* organizer);
+
+  // the organizer callbacks only hold on to the dirty flag of the instance that
+  // registered them
+  GamebryoArchiveIndex(const GamebryoArchiveIndex&)            = delete;
+  GamebryoArchiveIndex& operator=(const GamebryoArchiveIndex&) = delete;
+
+  /**
+   * @brief Brings the index up to date with the current setup, reading archives that
+   * are new or changed on disk in parallel. Queries do this automatically after mods
+   * or the profile change.
+   **/
+  void refresh();
+
+  /**
+   * @return the indexed archives, by increasing priority
+   **/
+  QStringList archives();
+
+  /**
+   * @brief Finds the archives that provide an asset.
+   *
+   * @param filePath path of the asset relative to the data directory, slashes and
+   * backslashes are equivalent and the case is ignored
+   * @return the archives, by increasing priority, the last one wins
+   **/
+  QStringList providers(const QString& filePath);
+
+  /**
+   * @return every asset that is provided by more than one archive
+   **/
+  std::vector<Conflict> conflicts();
+
+private:
+  struct Archive
+  {
+    QString path;
+    QDateTime lastModified;
+    qint64 size = -1;
+
+    // whether the entries of the archive are in m_Entries
+    bool active = false;
+    int priority = -1;
+
+    // normalized paths of the assets and their hashes, names[i] ends where
+    // names[i + 1] starts
+    QByteArray names;
+    std::vector<uint32_t> nameOffsets;
+    std::vector<std::size_t> keys;
+
+    QByteArrayView name(uint32_t entry) const
+    {
+      return QByteArrayView(names).sliced(nameOffsets[entry],
+                                          nameOffsets[entry + 1] - nameOffsets[entry]);
+    }
+  };
+
+  struct Provider
+  {
+    uint32_t archive;
+    uint32_t entry;
+  };
+
+  using Providers = QVarLengthArray<Provider, 2>;
+
+  // paths of the archives of the current setup, by increasing priority
+  QStringList archivePaths() const;
+
+  static void readArchive(Archive& archive);
+
+  void addEntries(uint32_t id);
+  void removeEntries(uint32_t id);
+
+  void refreshIfDirty();
+  void sortByPriority(Providers& providers) const;
+
+private:
+  MOBase::IOrganizer* m_Organizer;
+
+  // shared with the organizer callbacks, which only keep a weak reference to it
+  std::shared_ptr<bool> m_Dirty;
+
+  // archives are never removed, so their entries are ready when a mod is enabled again
+  std::vector<Archive> m_Archives;
+  QHash<QString, uint32_t> m_ArchiveIds;
+
+  // providers of each asset, keyed by the hash of its normalized path
+  QHash<std::size_t, Providers> m_Entries;
+};
+
+#endif  // GAMEBRYOARCHIVEINDEX_H
@@ -0,0 +1,75 @@
+#include "gamebryoarchivelist.h"
+#include "gamebryopluginname.h"
+
+#include <algorithm>
+#include <utility>
+
+GamebryoArchiveList::GamebryoArchiveList(QString value) : m_Value(std::move(value))
+{
+  if (m_Value.trimmed().isEmpty()) {
+    return;
+  }
+
+  const QStringView text = m_Value;
+
+  qsizetype start = 0;
+  while (start <= text.size()) {
+    qsizetype end = text.indexOf(u',', start);
+    if (end < 0) {
+      end = text.size();
+    }
+
+    qsizetype first = start;
+    qsizetype last  = end;
+    while (first < last && text[first].isSpace()) {
+      ++first;
+    }
+    while (last > first && text[last - 1].isSpace()) {
+      --last;
+    }
+
+    const QStringView archive = text.sliced(first, last - first);
+    m_Entries.push_back({first, last - first, pluginNameHash(archive)});
+
+    start = end + 1;
+  }
+}
+
+QStringView GamebryoArchiveList::view(const Entry& entry) const
+{
+  return QStringView(m_Value).sliced(entry.offset, entry.length);
+}
+
+qsizetype GamebryoArchiveList::indexOf(QStringView archive) const
+{
+  const std::size_t hash = pluginNameHash(archive);
+
+  for (std::size_t i = 0; i < m_Entries.size(); ++i) {
+    const Entry& entry = m_Entries[i];
+    if (entry.hash == hash && pluginNameEquals(view(entry), archive)) {
+      return static_cast<qsizetype>(i);
+    }
+  }
+
+  return -1;
+}
+
+QStringList GamebryoArchiveList::toStringList() const
+{
+  QStringList result;
+  result.reserve(size());
+
+  for (const Entry& entry : m_Entries) {
+    result.append(view(entry).toString());
+  }
+
+  return result;
+}
+
+bool GamebryoArchiveList::operator==(const GamebryoArchiveList& other) const
+{
+  return std::equal(m_Entries.begin(), m_Entries.end(), other.m_Entries.begin(),
+                    other.m_Entries.end(), [&](const Entry& lhs, const Entry& rhs) {
+                      return lhs.hash == rhs.hash && view(lhs) == other.view(rhs);
+                    });
+}
@@ -0,0 +1,57 @@
+#ifndef GAMEBRYOARCHIVELIST_H
+#define GAMEBRYOARCHIVELIST_H
+
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Comma-separated list of archives as stored in the game INI files.
+ *
+ * The value is kept as it was read, and the archives are views into it, trimmed of the
+ * spaces around the commas. Archives are matched case-insensitively through a hash of
+ * their name, like the games do.
+ */
+class GamebryoArchiveList
+{
+public:
+  GamebryoArchiveList() = default;
+  explicit GamebryoArchiveList(QString value);
+
+  qsizetype size() const { return static_cast<qsizetype>(m_Entries.size()); }
+  bool isEmpty() const { return m_Entries.empty(); }
+
+  /**
+   * @return the index of an archive, ignoring case, or -1
+   */
+  qsizetype indexOf(QStringView archive) const;
+
+  QStringList toStringList() const;
+
+  /**
+   * @return true if both lists have the same archives in the same order, regardless of
+   * the spacing around commas
+   */
+  bool operator==(const GamebryoArchiveList& other) const;
+
+private:
+  struct Entry
+  {
+    // position in m_Value
+    qsizetype offset;
+    qsizetype length;
+
+    std::size_t hash;
+  };
+
+  QStringView view(const Entry& entry) const;
+
+private:
+  QString m_Value;
+  std::vector<Entry> m_Entries;
+};
+
+#endif  // GAMEBRYOARCHIVELIST_H
@@ -0,0 +1,287 @@
+#include "gamebryoba2archive.h"
+#include "bsahash.h"
+#include "gamebryobytecursor.h"
+
+#include <QObject>
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+
+namespace
+{
+
+constexpr qsizetype GENERAL_RECORD_SIZE = 36;
+constexpr qsizetype TEXTURE_RECORD_SIZE = 24;
+constexpr qsizetype CHUNK_RECORD_SIZE   = 24;
+
+constexpr uint32_t STARFIELD_COMPRESSION_LZ4 = 3;
+
+struct Key
+{
+  uint32_t folderHash;
+  uint32_t nameHash;
+  uint32_t extension;
+
+  friend bool operator<(const Key& lhs, const Key& rhs)
+  {
+    return std::tie(lhs.folderHash, lhs.nameHash, lhs.extension) <
+           std::tie(rhs.folderHash, rhs.nameHash, rhs.extension);
+  }
+};
+
+Key fileKey(const GamebryoBA2Archive::File& file)
+{
+  return {file.folderHash, file.nameHash, file.extension};
+}
+
+// splits a path the way the archive hashes it
+Key pathKey(QByteArrayView filePath)
+{
+  qsizetype separator = filePath.size() - 1;
+  while (separator >= 0 && filePath[separator] != '/' && filePath[separator] != '\\') {
+    --separator;
+  }
+
+  const QByteArrayView folder =
+      separator < 0 ? QByteArrayView() : filePath.first(separator);
+  QByteArrayView name = filePath.sliced(separator + 1);
+  QByteArrayView extension;
+
+  const qsizetype dot = name.lastIndexOf('.');
+  if (dot >= 0) {
+    extension = name.sliced(dot + 1);
+    name      = name.first(dot);
+  }
+
+  // the extension is stored as its first four characters, padded with zeros
+  char buffer[4] = {};
+  for (qsizetype i = 0; i < 4 && i < extension.size(); ++i) {
+    const char c = extension[i];
+    buffer[i]    = (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+  }
+
+  Key key;
+  key.folderHash = ba2Hash(folder);
+  key.nameHash   = ba2Hash(name);
+  std::memcpy(&key.extension, buffer, sizeof(buffer));
+
+  return key;
+}
+
+}  // namespace
+
+GamebryoBA2Archive::GamebryoBA2Archive()
+    : m_Data(nullptr), m_Size(0), m_Version(0), m_Type(TYPE_GENERAL),
+      m_Compression(COMPRESSION_ZLIB)
+{}
+
+GamebryoBA2Archive::~GamebryoBA2Archive()
+{
+  close();
+}
+
+void GamebryoBA2Archive::open(const QString& filePath)
+{
+  close();
+
+  m_File = std::make_unique<QFile>(filePath);
+  if (!m_File->open(QIODevice::ReadOnly)) {
+    m_File.reset();
+    throw std::runtime_error(
+        QObject::tr("failed to open %1").arg(filePath).toUtf8().constData());
+  }
+
+  m_FilePath = filePath;
+  m_Size     = m_File->size();
+  m_Data     = m_File->map(0, m_Size);
+  if (m_Data == nullptr) {
+    close();
+    throw std::runtime_error(
+        QObject::tr("failed to map %1").arg(filePath).toUtf8().constData());
+  }
+
+  try {
+    readIndex();
+  } catch (const std::exception& e) {
+    close();
+    throw std::runtime_error(
+        QObject::tr("%1 is not a valid archive: %2").arg(filePath).arg(e.what())
+            .toUtf8()
+            .constData());
+  }
+}
+
+void GamebryoBA2Archive::close()
+{
+  m_Files.clear();
+  m_Chunks.clear();
+  m_Lookup.clear();
+
+  if (m_File) {
+    if (m_Data != nullptr) {
+      m_File->unmap(const_cast<uchar*>(m_Data));
+    }
+    m_File.reset();
+  }
+
+  m_FilePath.clear();
+  m_Data        = nullptr;
+  m_Size        = 0;
+  m_Version     = 0;
+  m_Type        = TYPE_GENERAL;
+  m_Compression = COMPRESSION_ZLIB;
+}
+
+void GamebryoBA2Archive::readIndex()
+{
+  const QByteArrayView data(m_Data, m_Size);
+  GamebryoByteCursor cursor(data);
+
+  if (cursor.take(4) != QByteArrayView("BTDX", 4)) {
+    throw std::runtime_error("not a BA2 archive");
+  }
+
+  m_Version = cursor.read<uint32_t>();
+  if (m_Version != VERSION_FALLOUT4 && m_Version != VERSION_STARFIELD &&
+      m_Version != VERSION_STARFIELD_LZ4 && m_Version != VERSION_FALLOUT4_NG &&
+      m_Version != VERSION_FALLOUT4_NG_V8) {
+    throw std::runtime_error("unsupported BA2 version");
+  }
+
+  const QByteArrayView type = cursor.take(4);
+  if (type == QByteArrayView("GNRL", 4)) {
+    m_Type = TYPE_GENERAL;
+  } else if (type == QByteArrayView("DX10", 4)) {
+    m_Type = TYPE_TEXTURE;
+  } else {
+    throw std::runtime_error("unsupported BA2 type");
+  }
+
+  const auto fileCount       = cursor.read<uint32_t>();
+  const auto nameTableOffset = cursor.read<uint64_t>();
+
+  // Starfield added fields to the header
+  if (m_Version == VERSION_STARFIELD || m_Version == VERSION_STARFIELD_LZ4) {
+    cursor.take(8);
+  }
+  if (m_Version == VERSION_STARFIELD_LZ4) {
+    m_Compression = cursor.read<uint32_t>() == STARFIELD_COMPRESSION_LZ4
+                        ? COMPRESSION_LZ4
+                        : COMPRESSION_ZLIB;
+  }
+
+  // the count comes from the file, check it before reserving anything
+  const qsizetype recordSize =
+      m_Type == TYPE_GENERAL ? GENERAL_RECORD_SIZE : TEXTURE_RECORD_SIZE;
+  if (static_cast<qint64>(fileCount) * recordSize > cursor.remaining()) {
+    throw std::runtime_error("invalid file count");
+  }
+
+  m_Files.reserve(fileCount);
+  m_Chunks.reserve(fileCount);
+
+  for (uint32_t i = 0; i < fileCount; ++i) {
+    File file{};
+    file.nameHash   = cursor.read<uint32_t>();
+    file.extension  = cursor.read<uint32_t>();
+    file.folderHash = cursor.read<uint32_t>();
+    file.firstChunk = static_cast<uint32_t>(m_Chunks.size());
+
+    if (m_Type == TYPE_GENERAL) {
+      cursor.read<uint32_t>();  // flags
+
+      Chunk chunk{};
+      chunk.offset     = cursor.read<uint64_t>();
+      chunk.packedSize = cursor.read<uint32_t>();
+      chunk.size       = cursor.read<uint32_t>();
+      cursor.read<uint32_t>();  // 0xBAADF00D
+
+      m_Chunks.push_back(chunk);
+      file.chunkCount = 1;
+    } else {
+      cursor.read<uint8_t>();  // unknown
+      file.chunkCount = cursor.read<uint8_t>();
+      cursor.read<uint16_t>();  // size of a chunk record
+      file.height   = cursor.read<uint16_t>();
+      file.width    = cursor.read<uint16_t>();
+      file.mipCount = cursor.read<uint8_t>();
+      file.format   = cursor.read<uint8_t>();
+      file.cubemap  = (cursor.read<uint8_t>() & 1) != 0;
+      cursor.read<uint8_t>();  // tile mode
+
+      if (file.chunkCount * CHUNK_RECORD_SIZE > cursor.remaining()) {
+        throw std::runtime_error("invalid chunk count");
+      }
+
+      for (uint32_t j = 0; j < file.chunkCount; ++j) {
+        Chunk chunk{};
+        chunk.offset     = cursor.read<uint64_t>();
+        chunk.packedSize = cursor.read<uint32_t>();
+        chunk.size       = cursor.read<uint32_t>();
+        chunk.firstMip   = cursor.read<uint16_t>();
+        chunk.lastMip    = cursor.read<uint16_t>();
+        cursor.read<uint32_t>();  // 0xBAADF00D
+
+        m_Chunks.push_back(chunk);
+      }
+    }
+
+    m_Files.push_back(file);
+  }
+
+  // the name table is optional, each name is prefixed by its length
+  if (nameTableOffset != 0) {
+    if (nameTableOffset > static_cast<uint64_t>(m_Size)) {
+      throw std::runtime_error("invalid name table offset");
+    }
+
+    GamebryoByteCursor names(data, static_cast<qsizetype>(nameTableOffset));
+    for (File& file : m_Files) {
+      file.name = names.take(names.read<uint16_t>());
+    }
+  }
+
+  m_Lookup.resize(m_Files.size());
+  std::iota(m_Lookup.begin(), m_Lookup.end(), 0);
+  std::sort(m_Lookup.begin(), m_Lookup.end(), [this](uint32_t lhs, uint32_t rhs) {
+    return fileKey(m_Files[lhs]) < fileKey(m_Files[rhs]);
+  });
+}
+
+const GamebryoBA2Archive::File*
+GamebryoBA2Archive::findFile(QByteArrayView filePath) const
+{
+  const Key key = pathKey(filePath);
+
+  auto it = std::lower_bound(m_Lookup.begin(), m_Lookup.end(), key,
+                             [this](uint32_t index, const Key& key) {
+                               return fileKey(m_Files[index]) < key;
+                             });
+
+  // hashes can collide, names tell the files apart if the archive has them
+  for (; it != m_Lookup.end(); ++it) {
+    const File& file = m_Files[*it];
+    if (key < fileKey(file)) {
+      break;
+    }
+    if (file.name.isEmpty() || bsaPathEquals(file.name, filePath)) {
+      return &file;
+    }
+  }
+
+  return nullptr;
+}
+
+QByteArrayView GamebryoBA2Archive::chunkData(const Chunk& chunk) const
+{
+  const QByteArrayView data(m_Data, m_Size);
+  if (chunk.offset > static_cast<uint64_t>(m_Size)) {
+    throw std::runtime_error("unexpected end of data");
+  }
+
+  GamebryoByteCursor cursor(data, static_cast<qsizetype>(chunk.offset));
+  return cursor.take(chunk.packedSize != 0 ? chunk.packedSize : chunk.size);
+}
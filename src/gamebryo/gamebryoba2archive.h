@@ -0,0 +1,147 @@
+#ifndef GAMEBRYOBA2ARCHIVE_H
+#define GAMEBRYOBA2ARCHIVE_H
+
+#include <QByteArrayView>
+#include <QFile>
+#include <QString>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Read-only index of a BA2 archive (Fallout 4, Fallout 76 and Starfield), both
+ * general (GNRL) and texture (DX10) archives.
+ *
+ * Works like GamebryoBSAArchive: the archive is memory-mapped, names are views into the
+ * name table and file and chunk records are stored in flat arrays. Lookups use the
+ * hashes stored in the archive.
+ */
+class GamebryoBA2Archive
+{
+public:
+  enum Version : uint32_t
+  {
+    VERSION_FALLOUT4       = 1,
+    VERSION_STARFIELD      = 2,
+    VERSION_STARFIELD_LZ4  = 3,
+    VERSION_FALLOUT4_NG    = 7,
+    VERSION_FALLOUT4_NG_V8 = 8
+  };
+
+  enum Type
+  {
+    TYPE_GENERAL,
+    TYPE_TEXTURE
+  };
+
+  enum Compression
+  {
+    COMPRESSION_ZLIB,
+
+    // raw LZ4 blocks, only for version 3
+    COMPRESSION_LZ4
+  };
+
+  struct Chunk
+  {
+    uint64_t offset;
+
+    // size of the compressed data, 0 if the chunk is not compressed
+    uint32_t packedSize;
+    uint32_t size;
+
+    // range of mipmaps in the chunk, only for texture archives
+    uint16_t firstMip;
+    uint16_t lastMip;
+  };
+
+  struct File
+  {
+    // hashes of the file name without extension and of the folder, and the first
+    // four characters of the extension
+    uint32_t nameHash;
+    uint32_t folderHash;
+    uint32_t extension;
+
+    // full path of the file, empty if the archive has no name table
+    QByteArrayView name;
+
+    // range of the chunks of this file in chunks(), general files have one chunk
+    uint32_t firstChunk;
+    uint32_t chunkCount;
+
+    // DDS header fields, only for texture archives
+    uint16_t width;
+    uint16_t height;
+    uint8_t mipCount;
+    uint8_t format;
+    bool cubemap;
+  };
+
+  GamebryoBA2Archive();
+  ~GamebryoBA2Archive();
+
+  GamebryoBA2Archive(const GamebryoBA2Archive&)            = delete;
+  GamebryoBA2Archive& operator=(const GamebryoBA2Archive&) = delete;
+
+  /**
+   * @brief Maps an archive and reads its index, replacing any archive opened before.
+   *
+   * @param filePath path of the archive
+   * @throws std::runtime_error if the file cannot be mapped or is not a supported BA2
+   **/
+  void open(const QString& filePath);
+
+  /**
+   * @brief Unmaps the archive. Views returned so far become invalid.
+   **/
+  void close();
+
+  bool isOpen() const { return m_Data != nullptr; }
+  const QString& filePath() const { return m_FilePath; }
+  uint32_t version() const { return m_Version; }
+  Type type() const { return m_Type; }
+  Compression compression() const { return m_Compression; }
+
+  // files in the order of the archive
+  const std::vector<File>& files() const { return m_Files; }
+  const std::vector<Chunk>& chunks() const { return m_Chunks; }
+
+  /**
+   * @brief Finds a file by path, relative to the data directory. Slashes and
+   * backslashes are equivalent and the case is ignored.
+   *
+   * @return the file, or nullptr if the archive does not contain it
+   **/
+  const File* findFile(QByteArrayView filePath) const;
+
+  /**
+   * @brief Returns the data of a chunk as stored in the archive, compressed if its
+   * packed size is not 0.
+   *
+   * @throws std::runtime_error if the data lies outside of the archive
+   **/
+  QByteArrayView chunkData(const Chunk& chunk) const;
+
+private:
+  void readIndex();
+
+private:
+  QString m_FilePath;
+  std::unique_ptr<QFile> m_File;
+  const uchar* m_Data;
+  qint64 m_Size;
+
+  uint32_t m_Version;
+  Type m_Type;
+  Compression m_Compression;
+
+  std::vector<File> m_Files;
+  std::vector<Chunk> m_Chunks;
+
+  // indices of m_Files sorted by folder hash, name hash and extension
+  std::vector<uint32_t> m_Lookup;
+};
+
+#endif  // GAMEBRYOBA2ARCHIVE_H
@@ -0,0 +1,267 @@
+#include "gamebryobsaarchive.h"
+#include "bsahash.h"
+#include "gamebryobytecursor.h"
+
+#include <QObject>
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace
+{
+
+constexpr uint32_t SIZE_MASK         = 0x3fffffff;
+constexpr uint32_t SIZE_COMPRESSION  = 0x40000000;
+constexpr qsizetype FILE_RECORD_SIZE = 16;
+
+}  // namespace
+
+GamebryoBSAArchive::GamebryoBSAArchive()
+    : m_Data(nullptr), m_Size(0), m_Version(0), m_Flags(0)
+{}
+
+GamebryoBSAArchive::~GamebryoBSAArchive()
+{
+  close();
+}
+
+void GamebryoBSAArchive::open(const QString& filePath)
+{
+  close();
+
+  m_File = std::make_unique<QFile>(filePath);
+  if (!m_File->open(QIODevice::ReadOnly)) {
+    m_File.reset();
+    throw std::runtime_error(
+        QObject::tr("failed to open %1").arg(filePath).toUtf8().constData());
+  }
+
+  m_FilePath = filePath;
+  m_Size     = m_File->size();
+  m_Data     = m_File->map(0, m_Size);
+  if (m_Data == nullptr) {
+    close();
+    throw std::runtime_error(
+        QObject::tr("failed to map %1").arg(filePath).toUtf8().constData());
+  }
+
+  try {
+    readIndex();
+  } catch (const std::exception& e) {
+    close();
+    throw std::runtime_error(
+        QObject::tr("%1 is not a valid archive: %2").arg(filePath).arg(e.what())
+            .toUtf8()
+            .constData());
+  }
+}
+
+void GamebryoBSAArchive::close()
+{
+  m_Folders.clear();
+  m_Files.clear();
+
+  if (m_File) {
+    if (m_Data != nullptr) {
+      m_File->unmap(const_cast<uchar*>(m_Data));
+    }
+    m_File.reset();
+  }
+
+  m_FilePath.clear();
+  m_Data    = nullptr;
+  m_Size    = 0;
+  m_Version = 0;
+  m_Flags   = 0;
+}
+
+void GamebryoBSAArchive::readIndex()
+{
+  const QByteArrayView data(m_Data, m_Size);
+  GamebryoByteCursor header(data);
+
+  if (header.take(4) != QByteArrayView("BSA\0", 4)) {
+    throw std::runtime_error("not a BSA archive");
+  }
+
+  m_Version = header.read<uint32_t>();
+  if (m_Version != VERSION_OBLIVION && m_Version != VERSION_FALLOUT3 &&
+      m_Version != VERSION_SKYRIMSE) {
+    throw std::runtime_error("unsupported BSA version");
+  }
+
+  const auto folderOffset = header.read<uint32_t>();
+  m_Flags                 = header.read<uint32_t>();
+  const auto folderCount  = header.read<uint32_t>();
+  const auto fileCount    = header.read<uint32_t>();
+  header.read<uint32_t>();  // total length of folder names
+  header.read<uint32_t>();  // total length of file names
+  header.read<uint32_t>();  // content flags
+
+  const qsizetype folderRecordSize = m_Version == VERSION_SKYRIMSE ? 24 : 16;
+
+  // counts come from the file, check them before reserving anything
+  if (static_cast<qint64>(folderCount) * folderRecordSize > m_Size ||
+      static_cast<qint64>(fileCount) * FILE_RECORD_SIZE > m_Size) {
+    throw std::runtime_error("invalid record counts");
+  }
+
+  m_Folders.reserve(folderCount);
+  m_Files.reserve(fileCount);
+
+  GamebryoByteCursor cursor(data, folderOffset);
+
+  uint32_t firstFile = 0;
+  for (uint32_t i = 0; i < folderCount; ++i) {
+    Folder folder;
+    folder.hash      = cursor.read<uint64_t>();
+    folder.fileCount = cursor.read<uint32_t>();
+    folder.firstFile = firstFile;
+    cursor.take(folderRecordSize - 12);  // offset, and padding for version 105
+
+    if (folder.fileCount > fileCount - firstFile) {
+      throw std::runtime_error("invalid file count");
+    }
+    firstFile += folder.fileCount;
+
+    m_Folders.push_back(folder);
+  }
+
+  // file records follow, in blocks per folder that start with the folder name
+  const bool compressed = (m_Flags & FLAG_COMPRESSED) != 0;
+  for (uint32_t i = 0; i < folderCount; ++i) {
+    Folder& folder = m_Folders[i];
+
+    if (m_Flags & FLAG_FOLDER_NAMES) {
+      const auto length = cursor.read<uint8_t>();
+      folder.name       = cursor.take(length);
+      if (folder.name.endsWith('\0')) {
+        folder.name.chop(1);
+      }
+    }
+
+    for (uint32_t j = 0; j < folder.fileCount; ++j) {
+      File file;
+      file.hash       = cursor.read<uint64_t>();
+      const auto size = cursor.read<uint32_t>();
+      file.offset     = cursor.read<uint32_t>();
+      file.size       = size & SIZE_MASK;
+      file.compressed = compressed != ((size & SIZE_COMPRESSION) != 0);
+      file.folder     = i;
+
+      m_Files.push_back(file);
+    }
+  }
+
+  if (m_Files.size() != fileCount) {
+    throw std::runtime_error("invalid file count");
+  }
+
+  // followed by the names of all files, in the same order
+  if (m_Flags & FLAG_FILE_NAMES) {
+    for (File& file : m_Files) {
+      file.name = cursor.takeZString();
+    }
+  }
+
+  // archives built by the official tools are sorted, but not all of the others are
+  const auto byHash = [](const auto& lhs, const auto& rhs) {
+    return lhs.hash < rhs.hash;
+  };
+
+  if (!std::is_sorted(m_Folders.begin(), m_Folders.end(), byHash)) {
+    std::vector<uint32_t> order(m_Folders.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+      return m_Folders[lhs].hash < m_Folders[rhs].hash;
+    });
+
+    std::vector<Folder> folders;
+    std::vector<uint32_t> position(order.size());
+    folders.reserve(order.size());
+    for (uint32_t i = 0; i < order.size(); ++i) {
+      folders.push_back(m_Folders[order[i]]);
+      position[order[i]] = i;
+    }
+
+    m_Folders = std::move(folders);
+    for (File& file : m_Files) {
+      file.folder = position[file.folder];
+    }
+  }
+
+  for (const Folder& folder : m_Folders) {
+    auto begin = m_Files.begin() + folder.firstFile;
+    auto end   = begin + folder.fileCount;
+    if (!std::is_sorted(begin, end, byHash)) {
+      std::stable_sort(begin, end, byHash);
+    }
+  }
+}
+
+const GamebryoBSAArchive::Folder*
+GamebryoBSAArchive::findFolder(QByteArrayView folderPath) const
+{
+  const uint64_t hash = bsaFolderHash(folderPath);
+
+  auto it = std::lower_bound(m_Folders.begin(), m_Folders.end(), hash,
+                             [](const Folder& folder, uint64_t hash) {
+                               return folder.hash < hash;
+                             });
+
+  // hashes can collide, names tell the folders apart if the archive has them
+  for (; it != m_Folders.end() && it->hash == hash; ++it) {
+    if (it->name.isEmpty() || bsaPathEquals(it->name, folderPath)) {
+      return &*it;
+    }
+  }
+
+  return nullptr;
+}
+
+const GamebryoBSAArchive::File*
+GamebryoBSAArchive::findFile(QByteArrayView filePath) const
+{
+  qsizetype separator = filePath.size() - 1;
+  while (separator >= 0 && filePath[separator] != '/' && filePath[separator] != '\\') {
+    --separator;
+  }
+
+  const Folder* folder =
+      findFolder(separator < 0 ? QByteArrayView() : filePath.first(separator));
+  if (folder == nullptr) {
+    return nullptr;
+  }
+
+  const QByteArrayView fileName = filePath.sliced(separator + 1);
+  const uint64_t hash           = bsaFileHash(fileName);
+
+  auto begin = m_Files.begin() + folder->firstFile;
+  auto end   = begin + folder->fileCount;
+  auto it    = std::lower_bound(begin, end, hash, [](const File& file, uint64_t hash) {
+    return file.hash < hash;
+  });
+
+  for (; it != end && it->hash == hash; ++it) {
+    if (it->name.isEmpty() || bsaPathEquals(it->name, fileName)) {
+      return &*it;
+    }
+  }
+
+  return nullptr;
+}
+
+QByteArrayView GamebryoBSAArchive::fileData(const File& file) const
+{
+  GamebryoByteCursor cursor(QByteArrayView(m_Data, m_Size), file.offset);
+  qsizetype size = file.size;
+
+  if (m_Version != VERSION_OBLIVION && (m_Flags & FLAG_EMBEDDED_NAMES)) {
+    const auto length = cursor.read<uint8_t>();
+    cursor.take(length);
+    size -= 1 + length;
+  }
+
+  return cursor.take(size);
+}
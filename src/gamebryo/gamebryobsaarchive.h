@@ -0,0 +1,138 @@
+#ifndef GAMEBRYOBSAARCHIVE_H
+#define GAMEBRYOBSAARCHIVE_H
+
+#include <QByteArrayView>
+#include <QFile>
+#include <QString>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Read-only index of a BSA archive (Oblivion, Fallout 3, New Vegas, Skyrim and
+ * Skyrim SE, versions 103 to 105).
+ *
+ * The archive is memory-mapped and only its folder and file records are parsed. Names
+ * are views into the mapping and records are stored in two arrays, so opening an
+ * archive does not allocate per entry. Lookups use the hashes stored in the archive.
+ */
+class GamebryoBSAArchive
+{
+public:
+  enum Version : uint32_t
+  {
+    VERSION_OBLIVION = 103,
+    VERSION_FALLOUT3 = 104,
+    VERSION_SKYRIMSE = 105
+  };
+
+  enum ArchiveFlags : uint32_t
+  {
+    FLAG_FOLDER_NAMES = 0x00000001,
+    FLAG_FILE_NAMES   = 0x00000002,
+    FLAG_COMPRESSED   = 0x00000004,
+
+    // file data starts with the full path of the file, only for version 104 and up
+    FLAG_EMBEDDED_NAMES = 0x00000100
+  };
+
+  struct Folder
+  {
+    uint64_t hash;
+
+    // path of the folder, empty if the archive does not store folder names
+    QByteArrayView name;
+
+    // range of the files of this folder in files()
+    uint32_t firstFile;
+    uint32_t fileCount;
+  };
+
+  struct File
+  {
+    uint64_t hash;
+
+    // name of the file without its folder, empty if the archive does not store file
+    // names
+    QByteArrayView name;
+
+    // index of the folder of this file in folders()
+    uint32_t folder;
+
+    // size and offset of the data as stored in the archive
+    uint32_t size;
+    uint32_t offset;
+
+    bool compressed;
+  };
+
+  GamebryoBSAArchive();
+  ~GamebryoBSAArchive();
+
+  GamebryoBSAArchive(const GamebryoBSAArchive&)            = delete;
+  GamebryoBSAArchive& operator=(const GamebryoBSAArchive&) = delete;
+
+  /**
+   * @brief Maps an archive and reads its index, replacing any archive opened before.
+   *
+   * @param filePath path of the archive
+   * @throws std::runtime_error if the file cannot be mapped or is not a supported BSA
+   **/
+  void open(const QString& filePath);
+
+  /**
+   * @brief Unmaps the archive. Views returned so far become invalid.
+   **/
+  void close();
+
+  bool isOpen() const { return m_Data != nullptr; }
+  const QString& filePath() const { return m_FilePath; }
+  uint32_t version() const { return m_Version; }
+  uint32_t flags() const { return m_Flags; }
+
+  // folders sorted by hash, and files sorted by hash within each folder
+  const std::vector<Folder>& folders() const { return m_Folders; }
+  const std::vector<File>& files() const { return m_Files; }
+
+  /**
+   * @brief Finds a folder by path, relative to the data directory. Slashes and
+   * backslashes are equivalent and the case is ignored.
+   *
+   * @return the folder, or nullptr if the archive does not contain it
+   **/
+  const Folder* findFolder(QByteArrayView folderPath) const;
+
+  /**
+   * @brief Finds a file by path, relative to the data directory. Slashes and
+   * backslashes are equivalent and the case is ignored.
+   *
+   * @return the file, or nullptr if the archive does not contain it
+   **/
+  const File* findFile(QByteArrayView filePath) const;
+
+  /**
+   * @brief Returns the data of a file as stored in the archive, after the embedded
+   * name if there is one. Compressed data starts with the uncompressed size.
+   *
+   * @throws std::runtime_error if the data lies outside of the archive
+   **/
+  QByteArrayView fileData(const File& file) const;
+
+private:
+  void readIndex();
+
+private:
+  QString m_FilePath;
+  std::unique_ptr<QFile> m_File;
+  const uchar* m_Data;
+  qint64 m_Size;
+
+  uint32_t m_Version;
+  uint32_t m_Flags;
+
+  std::vector<Folder> m_Folders;
+  std::vector<File> m_Files;
+};
+
+#endif  // GAMEBRYOBSAARCHIVE_H
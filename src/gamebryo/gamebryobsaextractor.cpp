@@ -0,0 +1,243 @@
+#include "gamebryobsaextractor.h"
+#include "bsahash.h"
+#include "gamebryoparallel.h"
+
+#include <QDir>
+#include <QFile>
+
+#include <lz4frame.h>
+#include <zlib.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+
+namespace
+{
+
+constexpr qsizetype DEFAULT_MEMORY_LIMIT = 256 * 1024 * 1024;
+
+// keeps the amount of decompressed data held by the workers below a limit, a single
+// file larger than the limit is still let through when nothing else is held
+class MemoryBudget
+{
+public:
+  MemoryBudget(qsizetype limit) : m_Limit(limit), m_Used(0) {}
+
+  void acquire(qsizetype size)
+  {
+    std::unique_lock lock(m_Mutex);
+    m_Released.wait(lock, [&] {
+      return m_Used == 0 || m_Used + size <= m_Limit;
+    });
+    m_Used += size;
+  }
+
+  void release(qsizetype size)
+  {
+    {
+      std::scoped_lock lock(m_Mutex);
+      m_Used -= size;
+    }
+    m_Released.notify_all();
+  }
+
+private:
+  std::mutex m_Mutex;
+  std::condition_variable m_Released;
+  qsizetype m_Limit;
+  qsizetype m_Used;
+};
+
+bool inflateZlib(QByteArrayView compressed, QByteArray& buffer)
+{
+  uLongf size = static_cast<uLongf>(buffer.size());
+  const int result =
+      uncompress(reinterpret_cast<Bytef*>(buffer.data()), &size,
+                 reinterpret_cast<const Bytef*>(compressed.data()),
+                 static_cast<uLong>(compressed.size()));
+
+  return result == Z_OK && size == static_cast<uLongf>(buffer.size());
+}
+
+bool decompressLz4Frame(QByteArrayView compressed, QByteArray& buffer)
+{
+  LZ4F_dctx* context = nullptr;
+  if (LZ4F_isError(LZ4F_createDecompressionContext(&context, LZ4F_VERSION))) {
+    return false;
+  }
+
+  std::size_t in  = 0;
+  std::size_t out = 0;
+  std::size_t hint;
+
+  do {
+    std::size_t inSize  = compressed.size() - in;
+    std::size_t outSize = buffer.size() - out;
+    hint = LZ4F_decompress(context, buffer.data() + out, &outSize,
+                           compressed.data() + in, &inSize, nullptr);
+    if (LZ4F_isError(hint) || (inSize == 0 && outSize == 0)) {
+      break;
+    }
+    in += inSize;
+    out += outSize;
+  } while (hint != 0);
+
+  LZ4F_freeDecompressionContext(context);
+
+  return hint == 0 && out == static_cast<std::size_t>(buffer.size());
+}
+
+}  // namespace
+
+GamebryoBSAExtractor::GamebryoBSAExtractor(const GamebryoBSAArchive& archive)
+    : m_Archive(archive), m_MaxThreads(0), m_MemoryLimit(DEFAULT_MEMORY_LIMIT)
+{}
+
+QString GamebryoBSAExtractor::filePath(const GamebryoBSAArchive::File& file) const
+{
+  const QByteArrayView folder = m_Archive.folders()[file.folder].name;
+
+  // archives without names only have hashes to go by
+  const QString fileName =
+      file.name.isEmpty() ? QString::number(file.hash, 16).rightJustified(16, '0')
+                          : bsaPathToString(file.name);
+
+  if (folder.isEmpty()) {
+    return fileName;
+  }
+
+  return bsaPathToString(folder) + "\\" + fileName;
+}
+
+qsizetype
+GamebryoBSAExtractor::decompressedSize(const GamebryoBSAArchive::File& file) const
+{
+  if (!file.compressed) {
+    return 0;
+  }
+
+  const QByteArrayView data = m_Archive.fileData(file);
+  if (data.size() < static_cast<qsizetype>(sizeof(uint32_t))) {
+    throw std::runtime_error("unexpected end of data");
+  }
+
+  uint32_t size;
+  std::memcpy(&size, data.data(), sizeof(size));
+  return size;
+}
+
+QByteArrayView GamebryoBSAExtractor::read(const GamebryoBSAArchive::File& file,
+                                          QByteArray& buffer) const
+{
+  const QByteArrayView data = m_Archive.fileData(file);
+  if (!file.compressed) {
+    return data;
+  }
+
+  buffer.resize(decompressedSize(file));
+
+  // compressed data starts with its original size
+  const QByteArrayView compressed = data.sliced(sizeof(uint32_t));
+  const bool success = m_Archive.version() == GamebryoBSAArchive::VERSION_SKYRIMSE
+                           ? decompressLz4Frame(compressed, buffer)
+                           : inflateZlib(compressed, buffer);
+
+  if (!success) {
+    throw std::runtime_error("failed to decompress");
+  }
+
+  return buffer;
+}
+
+bool GamebryoBSAExtractor::extract(const Sink& sink) const
+{
+  const auto& files = m_Archive.files();
+
+  MemoryBudget budget(m_MemoryLimit);
+  std::atomic<bool> success = true;
+
+  parallelFor(
+      files.size(),
+      [&](std::size_t i) {
+        const auto& file   = files[i];
+        const QString path = filePath(file);
+
+        qsizetype size = 0;
+        try {
+          size = decompressedSize(file);
+          budget.acquire(size);
+
+          QByteArray buffer;
+          if (!sink(path, read(file, buffer))) {
+            success = false;
+          }
+        } catch (const std::exception& e) {
+          qWarning("failed to extract %s from %s: %s", qUtf8Printable(path),
+                   qUtf8Printable(m_Archive.filePath()), e.what());
+          success = false;
+        }
+
+        budget.release(size);
+      },
+      m_MaxThreads);
+
+  return success;
+}
+
+bool GamebryoBSAExtractor::extract(const QString& directory) const
+{
+  const QDir root(directory);
+  const QString rootPath = QDir::cleanPath(root.absolutePath()) + "/";
+
+  // archives are not trusted to keep their paths inside of the directory
+  const auto targetPath = [&](const QString& archivePath) -> QString {
+    const QString path =
+        QDir::cleanPath(root.absoluteFilePath(QString(archivePath).replace('\\', '/')));
+    if (!path.startsWith(rootPath)) {
+      qWarning("skipping %s, it is outside of %s", qUtf8Printable(archivePath),
+               qUtf8Printable(directory));
+      return {};
+    }
+    return path;
+  };
+
+  // folders are created up front so the workers do not race to create them
+  bool success = true;
+  for (const auto& folder : m_Archive.folders()) {
+    if (folder.name.isEmpty()) {
+      continue;
+    }
+
+    const QString path = targetPath(bsaPathToString(folder.name));
+    if (path.isEmpty()) {
+      success = false;
+    } else if (!QDir().mkpath(path)) {
+      qWarning("failed to create %s", qUtf8Printable(path));
+      success = false;
+    }
+  }
+
+  return extract([&](const QString& filePath, QByteArrayView data) {
+    const QString path = targetPath(filePath);
+    if (path.isEmpty()) {
+      return false;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+      qWarning("failed to open %s", qUtf8Printable(path));
+      return false;
+    }
+
+    if (file.write(data.data(), data.size()) != data.size()) {
+      qWarning("failed to write %s", qUtf8Printable(path));
+      return false;
+    }
+
+    return true;
+  }) && success;
+}
@@ -0,0 +1,88 @@
+#ifndef GAMEBRYOBSAEXTRACTOR_H
+#define GAMEBRYOBSAEXTRACTOR_H
+
+#include "gamebryobsaarchive.h"
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * @brief Extracts the files of a BSA archive on a set of worker threads, decompressing
+ * zlib (versions 103 and 104) and LZ4 frame (version 105) data.
+ *
+ * Each worker handles one file at a time. Uncompressed files are handed out straight
+ * from the mapped archive, and decompressed data is counted against a memory limit so
+ * that large archives do not need more memory than that, plus one file that is larger
+ * than the limit on its own.
+ */
+class GamebryoBSAExtractor
+{
+public:
+  /**
+   * @brief Receives the data of a file. Called from the worker threads, possibly
+   * concurrently, and the data is only valid for the duration of the call.
+   *
+   * @param filePath path of the file in the archive, with backslashes
+   * @param data uncompressed content of the file
+   * @return false if the file could not be handled, extraction continues regardless
+   */
+  using Sink = std::function<bool(const QString& filePath, QByteArrayView data)>;
+
+  GamebryoBSAExtractor(const GamebryoBSAArchive& archive);
+
+  /**
+   * @param maxThreads maximum number of threads to use, 0 for one per core
+   */
+  void setMaxThreads(std::size_t maxThreads) { m_MaxThreads = maxThreads; }
+
+  /**
+   * @param bytes maximum amount of decompressed data held at once
+   */
+  void setMemoryLimit(qsizetype bytes) { m_MemoryLimit = bytes; }
+
+  /**
+   * @brief Extracts every file of the archive to a sink.
+   *
+   * @return true if every file was extracted and accepted by the sink
+   */
+  bool extract(const Sink& sink) const;
+
+  /**
+   * @brief Extracts every file of the archive below a directory, creating folders as
+   * needed. Files whose path would end up outside of the directory are skipped.
+   *
+   * @return true if every file was written
+   */
+  bool extract(const QString& directory) const;
+
+  /**
+   * @brief Reads the content of a single file, decompressing it into buffer if needed.
+   *
+   * @param file file of the archive
+   * @param buffer holds the decompressed data, untouched for uncompressed files
+   * @return the content, a view into the archive or into buffer
+   * @throws std::runtime_error if the data lies outside of the archive or cannot be
+   * decompressed
+   */
+  QByteArrayView read(const GamebryoBSAArchive::File& file, QByteArray& buffer) const;
+
+  /**
+   * @return the path of a file in the archive, with backslashes
+   */
+  QString filePath(const GamebryoBSAArchive::File& file) const;
+
+private:
+  // size of a file once decompressed, or 0 if it is not compressed
+  qsizetype decompressedSize(const GamebryoBSAArchive::File& file) const;
+
+private:
+  const GamebryoBSAArchive& m_Archive;
+  std::size_t m_MaxThreads;
+  qsizetype m_MemoryLimit;
+};
+
+#endif  // GAMEBRYOBSAEXTRACTOR_H
@@ -1,6 +1,7 @@
 #include "gamebryobsainvalidation.h"
 
 #include "dummybsa.h"
+#include "gamebryoinitransaction.h"
 #include "iplugingame.h"
 #include "iprofile.h"
 #include "registry.h"
@@ -8,7 +9,7 @@
 #include <utility.h>
 
 #include <QDir>
-#include <QSettings>
+#include <QFile>
 #include <QStringList>
 
 using namespace Qt::Literals::StringLiterals;
@@ -49,20 +50,18 @@ bool GamebryoBSAInvalidation::prepareProfile(MOBase::IProfile* profile)
                             : m_Game->documentsDirectory().absolutePath();
   QString iniFilePath = basePath + "/" + m_IniFileName;
 
-  QSettings ini(iniFilePath, QSettings::IniFormat);
+  // the archive list is changed in the same transaction, so the INI is written once
+  GamebryoIniTransaction transaction;
+  auto ini = transaction.file(iniFilePath);
 
   static const QString bInvalidateOlderFiles   = u"Archive/bInvalidateOlderFiles"_s;
   static const QString SInvalidationFile       = u"Archive/SInvalidationFile"_s;
   static const QString archiveInvalidationFile = u"ArchiveInvalidation.txt"_s;
 
   // write bInvalidateOlderFiles = 1, if needed
-  if (ini.value(bInvalidateOlderFiles, "0").toString() != "1") {
+  if (ini->value(bInvalidateOlderFiles, "0") != "1") {
     dirty = true;
-    ini.setValue(bInvalidateOlderFiles, "1");
-    if (ini.status() != QSettings::NoError) {
-      qWarning("failed to activate BSA invalidation in \"%s\"",
-               qUtf8Printable(m_IniFileName));
-    }
+    ini->setValue(bInvalidateOlderFiles, "1");
   }
 
   if (profile->invalidationActive(nullptr)) {
@@ -85,18 +84,15 @@ bool GamebryoBSAInvalidation::prepareProfile(MOBase::IProfile* profile)
     QString bsaFile = m_Game->dataDirectory().absoluteFilePath(invalidationBSAName());
     if (!QFile::exists(bsaFile)) {
       DummyBSA bsa(bsaVersion());
-      bsa.write(bsaFile);
-      dirty = true;
+      if (bsa.write(bsaFile)) {
+        dirty = true;
+      }
     }
 
     // write SInvalidationFile = "", if needed
-    if (ini.value(SInvalidationFile, "").toString() != "") {
+    if (!ini->value(SInvalidationFile).isEmpty()) {
       dirty = true;
-      ini.setValue(SInvalidationFile, "");
-      if (ini.status() != QSettings::NoError) {
-        qWarning("failed to activate BSA invalidation in \"%s\"",
-                 qUtf8Printable(m_IniFileName));
-      }
+      ini->setValue(SInvalidationFile, "");
     }
   } else {
 
@@ -117,15 +113,16 @@ bool GamebryoBSAInvalidation::prepareProfile(MOBase::IProfile* profile)
     }
 
     // write SInvalidationFile = "ArchiveInvalidation.txt", if needed
-    if (ini.value(SInvalidationFile, "").toString() != archiveInvalidationFile) {
+    if (ini->value(SInvalidationFile) != archiveInvalidationFile) {
       dirty = true;
-      ini.setValue(SInvalidationFile, archiveInvalidationFile);
-      if (ini.status() != QSettings::NoError) {
-        qWarning("failed to activate BSA invalidation in \"%s\"",
-                 qUtf8Printable(m_IniFileName));
-      }
+      ini->setValue(SInvalidationFile, archiveInvalidationFile);
     }
   }
 
+  if (!transaction.commit()) {
+    qWarning("failed to activate BSA invalidation in \"%s\"",
+             qUtf8Printable(m_IniFileName));
+  }
+
   return dirty;
 }
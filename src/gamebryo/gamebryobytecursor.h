@@ -0,0 +1,58 @@
+#ifndef GAMEBRYOBYTECURSOR_H
+#define GAMEBRYOBYTECURSOR_H
+
+#include <QByteArrayView>
+
+#include <cstring>
+#include <stdexcept>
+
+/**
+ * @brief Sequential reader over a block of memory, such as a mapped file. Throws
+ * std::runtime_error instead of reading past its end.
+ */
+class GamebryoByteCursor
+{
+public:
+  GamebryoByteCursor(QByteArrayView data, qsizetype pos = 0) : m_Data(data), m_Pos(pos)
+  {}
+
+  template <typename T>
+  T read()
+  {
+    T value;
+    std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+    return value;
+  }
+
+  QByteArrayView take(qsizetype size)
+  {
+    if (size < 0 || size > remaining()) {
+      throw std::runtime_error("unexpected end of data");
+    }
+    QByteArrayView result = m_Data.sliced(m_Pos, size);
+    m_Pos += size;
+    return result;
+  }
+
+  // reads a null-terminated string, the terminator is consumed but not returned
+  QByteArrayView takeZString()
+  {
+    const qsizetype end = m_Data.indexOf('\0', m_Pos);
+    if (end < 0) {
+      throw std::runtime_error("unterminated string");
+    }
+    QByteArrayView result = m_Data.sliced(m_Pos, end - m_Pos);
+    m_Pos                 = end + 1;
+    return result;
+  }
+
+  qsizetype pos() const { return m_Pos; }
+  qsizetype remaining() const { return m_Data.size() - m_Pos; }
+  bool atEnd() const { return remaining() == 0; }
+
+private:
+  QByteArrayView m_Data;
+  qsizetype m_Pos;
+};
+
+#endif  // GAMEBRYOBYTECURSOR_H
@@ -1,13 +1,20 @@
 #include "gamebryodataarchives.h"
 
-#include <QSettings>
-#include <registry.h>
+#include <scopeguard.h>
 #include <utility.h>
 
+#include "gamebryoinicache.h"
+#include "gamebryoinitransaction.h"
+#include "gamebryopluginname.h"
 #include "gamegamebryo.h"
 
+#include <algorithm>
+
 using namespace Qt::Literals::StringLiterals;
 
+thread_local std::vector<GamebryoArchiveList>* GamebryoDataArchives::s_ReadLists =
+    nullptr;
+
 GamebryoDataArchives::GamebryoDataArchives(const GameGamebryo* game) : m_Game{game} {}
 
 QDir GamebryoDataArchives::gameDirectory() const
@@ -20,41 +27,116 @@ QDir GamebryoDataArchives::localGameDirectory() const
   return QDir(m_Game->myGamesPath()).absolutePath();
 }
 
+QString GamebryoDataArchives::archiveListKey(const QString& iniFile, const QString& key)
+{
+  return QDir::cleanPath(QDir::fromNativeSeparators(iniFile)).toLower() % "/" %
+         key.toLower();
+}
+
 QStringList GamebryoDataArchives::getArchivesFromKey(const QString& iniFile,
                                                      const QString& key,
                                                      const int size) const
 {
-  QSettings ini(iniFile, QSettings::IniFormat);
-  QStringList result;
-  auto value = ini.value(u"Archive/"_s % key);
-  if (value.isValid()) {
-    result = value.toString().split(',');
+  auto ini = GamebryoIniCache::instance().file(iniFile);
+
+  std::scoped_lock lock(m_ArchiveListsMutex);
+
+  // the list is only split again when the INI changed since
+  ArchiveList& list = m_ArchiveLists[archiveListKey(iniFile, key)];
+  if (list.generation != ini->generation()) {
+    GamebryoArchiveList archives(ini->value(u"Archive/"_s % key));
+    QStringList result = archives.toStringList();
+    list               = {ini->generation(), std::move(archives), std::move(result)};
   }
 
-  for (auto& item : result) {
-    item = item.trimmed();
+  if (s_ReadLists != nullptr) {
+    s_ReadLists->push_back(list.entries);
   }
 
-  return result;
+  return list.archives;
 }
 
 void GamebryoDataArchives::setArchivesToKey(const QString& iniFile, const QString& key,
                                             const QString& value)
 {
-  if (!MOBase::WriteRegistryValue(u"Archive"_s, key, value, iniFile)) {
+  // joins the transaction of the feature preparing the profile, if any
+  GamebryoIniTransaction transaction;
+  auto ini = transaction.file(iniFile);
+
+  GamebryoArchiveList archives(value);
+
+  {
+    std::scoped_lock lock(m_ArchiveListsMutex);
+    ArchiveList& list = m_ArchiveLists[archiveListKey(iniFile, key)];
+
+    // the same archives with different spacing are left as they are in the file
+    if (list.generation != ini->generation() || list.entries != archives) {
+      ini->setValue(u"Archive/"_s % key, value);
+
+      // the new list is known, so reading it back does not split it again
+      QStringList result = archives.toStringList();
+      list = {ini->generation(), std::move(archives), std::move(result)};
+    }
+  }
+
+  if (!transaction.commit()) {
     qWarning("failed to set archives in \"%s\"", qUtf8Printable(iniFile));
   }
 }
 
+QStringList
+GamebryoDataArchives::readArchives(MOBase::IProfile* profile,
+                                   std::vector<GamebryoArchiveList>& lists) const
+{
+  s_ReadLists = &lists;
+  ON_BLOCK_EXIT([]() {
+    s_ReadLists = nullptr;
+  });
+
+  return archives(profile);
+}
+
+qsizetype GamebryoDataArchives::indexOf(const QStringList& archives,
+                                        const std::vector<GamebryoArchiveList>& lists,
+                                        const QString& archiveName)
+{
+  qsizetype count = 0;
+  for (const auto& list : lists) {
+    count += list.size();
+  }
+
+  // games that do not build the list from INI keys alone are searched one by one
+  if (count != archives.size()) {
+    const auto it = std::find_if(archives.begin(), archives.end(),
+                                 [&](const QString& archive) {
+                                   return pluginNameEquals(archive, archiveName);
+                                 });
+    return it != archives.end() ? it - archives.begin() : -1;
+  }
+
+  qsizetype offset = 0;
+  for (const auto& list : lists) {
+    const qsizetype index = list.indexOf(archiveName);
+    if (index >= 0) {
+      return offset + index;
+    }
+    offset += list.size();
+  }
+
+  return -1;
+}
+
 void GamebryoDataArchives::addArchive(MOBase::IProfile* profile, int index,
                                       const QString& archiveName)
 {
-  QStringList current = archives(profile);
-  if (current.contains(archiveName, Qt::CaseInsensitive)) {
+  std::vector<GamebryoArchiveList> lists;
+  QStringList current = readArchives(profile, lists);
+  if (indexOf(current, lists, archiveName) >= 0) {
     return;
   }
 
-  current.insert(index != INT_MAX ? index : current.size(), archiveName);
+  // the game decides how the list is split across keys when it is written
+  current.insert(std::clamp<qsizetype>(index, 0, current.size()), archiveName);
 
   writeArchiveList(profile, current);
 }
@@ -62,11 +144,20 @@ void GamebryoDataArchives::addArchive(MOBase::IProfile* profile, int index,
 void GamebryoDataArchives::removeArchive(MOBase::IProfile* profile,
                                          const QString& archiveName)
 {
-  QStringList current = archives(profile);
-  if (!current.contains(archiveName, Qt::CaseInsensitive)) {
+  std::vector<GamebryoArchiveList> lists;
+  QStringList current = readArchives(profile, lists);
+
+  const qsizetype index = indexOf(current, lists, archiveName);
+  if (index < 0) {
     return;
   }
-  current.removeAll(archiveName);
+
+  // the archive can be listed more than once, but never before the first match
+  current.erase(std::remove_if(current.begin() + index, current.end(),
+                               [&](const QString& archive) {
+                                 return pluginNameEquals(archive, archiveName);
+                               }),
+                current.end());
 
   writeArchiveList(profile, current);
 }
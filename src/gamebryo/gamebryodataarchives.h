@@ -1,7 +1,14 @@
 #ifndef GAMEBRYODATAARCHIVES_H
 #define GAMEBRYODATAARCHIVES_H
 
+#include "gamebryoarchivelist.h"
+
 #include <QDir>
+#include <QHash>
+#include <QStringList>
+
+#include <mutex>
+#include <vector>
 
 #include "dataarchives.h"
 
@@ -28,8 +35,40 @@ protected:
                         const QString& value);
 
 private:
+  struct ArchiveList
+  {
+    // generation of the INI file the list was read from
+    quint64 generation = 0;
+    GamebryoArchiveList entries;
+    QStringList archives;
+  };
+
+  static QString archiveListKey(const QString& iniFile, const QString& key);
+
+  /**
+   * @brief Calls archives(), keeping the parsed list of every key it reads.
+   */
+  QStringList readArchives(MOBase::IProfile* profile,
+                           std::vector<GamebryoArchiveList>& lists) const;
+
+  /**
+   * @return the index of an archive, found through the hashes of the parsed lists if
+   * the archives are exactly the ones in the lists, or -1
+   */
+  static qsizetype indexOf(const QStringList& archives,
+                           const std::vector<GamebryoArchiveList>& lists,
+                           const QString& archiveName);
+
+  // lists parsed by getArchivesFromKey() while readArchives() runs on this thread
+  static thread_local std::vector<GamebryoArchiveList>* s_ReadLists;
+
   const GameGamebryo* m_Game;
 
+  // archive lists by INI file and key, the file depends on the profile when it has
+  // its own INI files
+  mutable std::mutex m_ArchiveListsMutex;
+  mutable QHash<QString, ArchiveList> m_ArchiveLists;
+
   virtual void writeArchiveList(MOBase::IProfile* profile,
                                 const QStringList& before) = 0;
 };
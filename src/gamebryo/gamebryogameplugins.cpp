@@ -1,24 +1,30 @@
 #include "gamebryogameplugins.h"
+#include "gamebryopluginlistfile.h"
+#include "gamebryopluginname.h"
+#include "gamebryopluginstates.h"
 #include <imodinterface.h>
 #include <iplugingame.h>
 #include <ipluginlist.h>
 #include <report.h>
-#include <safewritefile.h>
 #include <scopeguard.h>
 #include <utility.h>
 
 #include <QDateTime>
 #include <QDir>
+#include <QSet>
 #include <QString>
 #include <QStringEncoder>
 #include <QStringList>
 
+#include <algorithm>
+#include <future>
+
 using MOBase::IOrganizer;
 using MOBase::IPluginList;
 using MOBase::reportError;
-using MOBase::SafeWriteFile;
 
-GamebryoGamePlugins::GamebryoGamePlugins(IOrganizer* organizer) : m_Organizer(organizer)
+GamebryoGamePlugins::GamebryoGamePlugins(IOrganizer* organizer)
+    : m_Organizer(organizer), m_HeaderCacheLoaded(false)
 {}
 
 void GamebryoGamePlugins::writePluginLists(const IPluginList* pluginList)
@@ -28,10 +34,31 @@ void GamebryoGamePlugins::writePluginLists(const IPluginList* pluginList)
     return;
   }
 
-  writePluginList(pluginList, getPluginsPath());
-  writeLoadOrderList(pluginList, getLoadOrderPath());
+  const GamebryoPluginListSnapshot snapshot(pluginList);
+  const QString pluginsPath   = getPluginsPath();
+  const QString loadOrderPath = getLoadOrderPath();
+
+  auto loadOrderValid = std::async(std::launch::async, [&]() {
+    return writeLoadOrderList(snapshot, loadOrderPath);
+  });
+  const bool pluginsValid = writePluginList(snapshot, pluginsPath);
+
+  if (!loadOrderValid.get() || !pluginsValid) {
+    reportInvalidNames();
+  }
+
+  GamebryoPluginListJournal::State state;
+  state.reserve(snapshot.plugins().size());
+  for (const auto& plugin : snapshot.plugins()) {
+    state.push_back({plugin.name, plugin.state == IPluginList::STATE_ACTIVE});
+  }
+  journal().record(state);
 
   m_LastRead = QDateTime::currentDateTime();
+
+  if (m_HeaderCacheLoaded) {
+    m_HeaderCache.save(headerCachePath());
+  }
 }
 
 void GamebryoGamePlugins::readPluginLists(MOBase::IPluginList* pluginList)
@@ -57,6 +84,10 @@ void GamebryoGamePlugins::readPluginLists(MOBase::IPluginList* pluginList)
   }
 
   m_LastRead = QDateTime::currentDateTime();
+
+  if (m_HeaderCacheLoaded) {
+    m_HeaderCache.save(headerCachePath());
+  }
 }
 
 QStringList GamebryoGamePlugins::getLoadOrder()
@@ -79,65 +110,82 @@ QStringList GamebryoGamePlugins::getLoadOrder()
 void GamebryoGamePlugins::writePluginList(const MOBase::IPluginList* pluginList,
                                           const QString& filePath)
 {
-  return writeList(pluginList, filePath, false);
+  if (!writePluginList(GamebryoPluginListSnapshot(pluginList), filePath)) {
+    reportInvalidNames();
+  }
 }
 
 void GamebryoGamePlugins::writeLoadOrderList(const MOBase::IPluginList* pluginList,
                                              const QString& filePath)
 {
-  return writeList(pluginList, filePath, true);
+  if (!writeLoadOrderList(GamebryoPluginListSnapshot(pluginList), filePath)) {
+    reportInvalidNames();
+  }
 }
 
-void GamebryoGamePlugins::writeList(const IPluginList* pluginList,
-                                    const QString& filePath, bool loadOrder)
+bool GamebryoGamePlugins::writePluginList(const GamebryoPluginListSnapshot& snapshot,
+                                          const QString& filePath)
 {
-  SafeWriteFile file(filePath);
-
-  QStringEncoder encoder = loadOrder
-                               ? QStringEncoder(QStringConverter::Encoding::Utf8)
-                               : QStringEncoder(QStringConverter::Encoding::System);
+  return writeList(snapshot, filePath, false);
+}
 
-  file->resize(0);
+bool GamebryoGamePlugins::writeLoadOrderList(const GamebryoPluginListSnapshot& snapshot,
+                                             const QString& filePath)
+{
+  return writeList(snapshot, filePath, true);
+}
 
-  file->write(
-      encoder.encode("# This file was automatically generated by Mod Organizer.\r\n"));
+void GamebryoGamePlugins::reportInvalidNames()
+{
+  reportError(QObject::tr("Some of your plugins have invalid names! These "
+                          "plugins can not be loaded by the game. Please see "
+                          "mo_interface.log for a list of affected plugins "
+                          "and rename them."));
+}
 
-  bool invalidFileNames = false;
-  int writtenCount      = 0;
+bool GamebryoGamePlugins::writeList(const GamebryoPluginListSnapshot& snapshot,
+                                    const QString& filePath, bool loadOrder)
+{
+  GamebryoPluginListWriter writer(loadOrder ? QStringConverter::Encoding::Utf8
+                                            : QStringConverter::Encoding::System);
 
-  QStringList plugins = pluginList->pluginNames();
-  std::sort(plugins.begin(), plugins.end(),
-            [pluginList](const QString& lhs, const QString& rhs) {
-              return pluginList->priority(lhs) < pluginList->priority(rhs);
-            });
+  writer.addComment(u"This file was automatically generated by Mod Organizer.");
 
-  for (const QString& pluginName : plugins) {
-    if (loadOrder || (pluginList->state(pluginName) == IPluginList::STATE_ACTIVE)) {
-      auto result = encoder.encode(pluginName);
-      if (encoder.hasError()) {
-        invalidFileNames = true;
-        qCritical("invalid plugin name %s", qUtf8Printable(pluginName));
-      } else {
-        file->write(result);
-      }
-      file->write("\r\n");
-      ++writtenCount;
+  for (const auto& plugin : snapshot.plugins()) {
+    if (loadOrder || (plugin.state == IPluginList::STATE_ACTIVE)) {
+      writer.addPlugin(plugin.name);
     }
   }
 
-  if (invalidFileNames) {
-    reportError(QObject::tr("Some of your plugins have invalid names! These "
-                            "plugins can not be loaded by the game. Please see "
-                            "mo_interface.log for a list of affected plugins "
-                            "and rename them."));
-  }
-
-  if (writtenCount == 0) {
+  if (writer.count() == 0) {
     qWarning("plugin list would be empty, this is almost certainly wrong. Not "
              "saving.");
   } else {
-    file.commitIfDifferent(m_LastSaveHash[filePath]);
+    commitListFile(writer, filePath);
   }
+
+  return !writer.hasInvalidNames();
+}
+
+GamebryoPluginListCache::LinesPtr
+GamebryoGamePlugins::readListFile(const QString& filePath,
+                                  QStringConverter::Encoding encoding)
+{
+  return m_ListCache.read(filePath, encoding);
+}
+
+void GamebryoGamePlugins::commitListFile(GamebryoPluginListWriter& writer,
+                                         const QString& filePath)
+{
+  if (writer.commitIfDifferent(filePath, lastSaveHash(filePath))) {
+    m_ListCache.store(filePath, writer.takeLines());
+  }
+}
+
+QByteArray& GamebryoGamePlugins::lastSaveHash(const QString& filePath)
+{
+  std::scoped_lock lock(m_LastSaveHashMutex);
+  return m_LastSaveHash[filePath];
 }
 
 QStringList GamebryoGamePlugins::readLoadOrderList(MOBase::IPluginList* pluginList,
@@ -145,20 +193,18 @@ QStringList GamebryoGamePlugins::readLoadOrderList(MOBase::IPluginList* pluginLi
 {
   QStringList pluginNames = organizer()->managedGame()->primaryPlugins();
 
-  std::set<QString> pluginLookup;
-  for (auto&& name : pluginNames) {
-    pluginLookup.insert(name.toLower());
+  QSet<GamebryoPluginName> pluginLookup(pluginNames.begin(), pluginNames.end());
+
+  const auto lines = readListFile(filePath, QStringConverter::Encoding::Utf8);
+  if (!lines) {
+    return readPluginList(pluginList);
   }
 
-  const auto b = MOBase::forEachLineInFile(filePath, [&](QString s) {
-    if (!pluginLookup.contains(s.toLower())) {
-      pluginLookup.insert(s);
-      pluginNames.push_back(std::move(s));
+  for (const auto& line : *lines) {
+    if (!pluginLookup.contains(line.name)) {
+      pluginLookup.insert(line.name);
+      pluginNames.push_back(line.name);
     }
-  });
-
-  if (!b) {
-    return readPluginList(pluginList);
   }
 
   return pluginNames;
@@ -166,82 +212,249 @@ QStringList GamebryoGamePlugins::readLoadOrderList(MOBase::IPluginList* pluginLi
 
 QStringList GamebryoGamePlugins::readPluginList(MOBase::IPluginList* pluginList)
 {
+  GamebryoPluginStates states(pluginList);
+
   QStringList primary = organizer()->managedGame()->primaryPlugins();
   for (const QString& pluginName : primary) {
-    if (pluginList->state(pluginName) != IPluginList::STATE_MISSING) {
-      pluginList->setState(pluginName, IPluginList::STATE_ACTIVE);
-    }
+    states.set(pluginName, IPluginList::STATE_ACTIVE);
   }
   QStringList plugins = pluginList->pluginNames();
-  QStringList pluginsClone(plugins);
   // Do not sort the primary plugins. Their load order should be locked as defined in
   // "primaryPlugins".
-  for (const auto& plugin : pluginsClone) {
-    if (primary.contains(plugin, Qt::CaseInsensitive))
-      plugins.removeAll(plugin);
-  }
+  const QSet<GamebryoPluginName> primarySet(primary.begin(), primary.end());
+  plugins.removeIf([&](const QString& plugin) {
+    return primarySet.contains(plugin);
+  });
 
   // Always use filetime loadorder to get the actual load order
-  std::sort(plugins.begin(), plugins.end(),
-            [&](const QString& lhs, const QString& rhs) {
-              MOBase::IModInterface* lhm =
-                  organizer()->modList()->getMod(pluginList->origin(lhs));
-              MOBase::IModInterface* rhm =
-                  organizer()->modList()->getMod(pluginList->origin(rhs));
-              QDir lhd = organizer()->managedGame()->dataDirectory();
-              QDir rhd = organizer()->managedGame()->dataDirectory();
-              if (lhm != nullptr)
-                lhd = lhm->absolutePath();
-              if (rhm != nullptr)
-                rhd = rhm->absolutePath();
-              QString lhp = lhd.absoluteFilePath(lhs);
-              QString rhp = rhd.absoluteFilePath(rhs);
-              return QFileInfo(lhp).lastModified() < QFileInfo(rhp).lastModified();
-            });
+  plugins = sortByFileTime(pluginList, plugins);
 
   // Determine plugin active state by the plugins.txt file.
-  bool pluginsTxtExists = true;
-  QString filePath      = getPluginsPath();
-  QFile file(filePath);
-  if (!file.open(QIODevice::ReadOnly)) {
-    pluginsTxtExists = false;
-  }
-  ON_BLOCK_EXIT([&]() {
-    file.close();
-  });
+  if (const auto pluginsTxt =
+          readListFile(getPluginsPath(), QStringConverter::Encoding::System)) {
+    for (const auto& line : *pluginsTxt) {
+      states.set(line.name, IPluginList::STATE_ACTIVE);
+    }
+  }
 
-  if (file.size() == 0) {
-    // MO stores at least a header in the file. if it's completely empty the
-    // file is broken
-    pluginsTxtExists = false;
-  }
-
-  QStringList activePlugins;
-  QStringList inactivePlugins;
-  if (pluginsTxtExists) {
-    while (!file.atEnd()) {
-      QByteArray line = file.readLine();
-      QString pluginName;
-      if ((line.size() > 0) && (line.at(0) != '#')) {
-        QStringEncoder encoder(QStringConverter::Encoding::System);
-        pluginName = encoder.encode(line.trimmed().constData());
-      }
-      if (pluginName.size() > 0) {
-        pluginList->setState(pluginName, IPluginList::STATE_ACTIVE);
-        activePlugins.push_back(pluginName);
+  // everything not listed in plugins.txt is inactive
+  for (const QString& pluginName : plugins) {
+    states.setDefault(pluginName, IPluginList::STATE_INACTIVE);
+  }
+
+  states.apply();
+
+  return primary + plugins;
+}
+
+QStringList GamebryoGamePlugins::sortByFileTime(const IPluginList* pluginList,
+                                                const QStringList& plugins)
+{
+  // plugins are sorted starting from the order of the last sort, or loadorder.txt on
+  // the first one, so that it decides between plugins with the same file time; the
+  // file times themselves are always read again since tools change them to reorder
+  QStringList previous = m_FileTimeOrder;
+  if (previous.isEmpty()) {
+    if (const auto loadOrder =
+            readListFile(getLoadOrderPath(), QStringConverter::Encoding::Utf8)) {
+      for (const auto& line : *loadOrder) {
+        previous.append(line.name);
       }
     }
+  }
 
-    for (const auto& pluginName : plugins) {
-      if (!activePlugins.contains(pluginName, Qt::CaseInsensitive)) {
-        pluginList->setState(pluginName, IPluginList::STATE_INACTIVE);
-      }
+  QSet<GamebryoPluginName> pending(plugins.begin(), plugins.end());
+
+  struct Entry
+  {
+    QString name;
+    QDateTime lastModified;
+  };
+
+  std::vector<Entry> entries;
+  entries.reserve(plugins.size());
+  for (const QString& pluginName : previous) {
+    auto it = pending.find(pluginName);
+    if (it != pending.end()) {
+      entries.push_back({it->name(), {}});
+      pending.erase(it);
     }
-  } else {
-    for (const QString& pluginName : plugins) {
-      pluginList->setState(pluginName, IPluginList::STATE_INACTIVE);
+  }
+
+  for (const QString& pluginName : plugins) {
+    if (pending.contains(pluginName)) {
+      entries.push_back({pluginName, {}});
     }
   }
 
-  return primary + plugins;
+  // each plugin is stat'ed once instead of twice per comparison
+  for (auto& entry : entries) {
+    entry.lastModified = QFileInfo(pluginPath(pluginList, entry.name)).lastModified();
+  }
+
+  std::stable_sort(entries.begin(), entries.end(),
+                   [](const Entry& lhs, const Entry& rhs) {
+                     return lhs.lastModified < rhs.lastModified;
+                   });
+
+  QStringList result;
+  result.reserve(entries.size());
+  for (auto& entry : entries) {
+    result.append(std::move(entry.name));
+  }
+
+  m_FileTimeOrder = result;
+
+  return result;
+}
+
+QString GamebryoGamePlugins::pluginPath(const IPluginList* pluginList,
+                                        const QString& pluginName) const
+{
+  QDir directory = organizer()->managedGame()->dataDirectory();
+
+  MOBase::IModInterface* mod =
+      organizer()->modList()->getMod(pluginList->origin(pluginName));
+  if (mod != nullptr) {
+    directory = mod->absolutePath();
+  }
+
+  return directory.absoluteFilePath(pluginName);
+}
+
+std::shared_ptr<const GamebryoPluginHeader>
+GamebryoGamePlugins::pluginHeader(const QString& pluginName)
+{
+  return headerCache().header(pluginPath(m_Organizer->pluginList(), pluginName));
+}
+
+std::vector<std::shared_ptr<const GamebryoPluginHeader>>
+GamebryoGamePlugins::pluginHeaders(const QStringList& pluginNames)
+{
+  const IPluginList* pluginList = m_Organizer->pluginList();
+
+  QStringList paths;
+  paths.reserve(pluginNames.size());
+  for (const QString& pluginName : pluginNames) {
+    paths.append(pluginPath(pluginList, pluginName));
+  }
+
+  return headerCache().headers(paths);
+}
+
+bool GamebryoGamePlugins::isLightPlugin(const QString& pluginName)
+{
+  if (!lightPluginsAreSupported()) {
+    return false;
+  }
+
+  if (auto header = pluginHeader(pluginName)) {
+    return header->isLight(mediumPluginsAreSupported());
+  }
+
+  return pluginName.endsWith(".esl", Qt::CaseInsensitive);
+}
+
+GamebryoLoadOrderValidator
+GamebryoGamePlugins::validateLoadOrder(const QStringList& loadOrder)
+{
+  std::vector<QStringList> masters;
+  masters.reserve(loadOrder.size());
+  for (const auto& header : pluginHeaders(loadOrder)) {
+    masters.push_back(header ? header->masters() : QStringList());
+  }
+
+  GamebryoLoadOrderValidator validator;
+  validator.setLoadOrder(loadOrder, masters);
+
+  for (const auto& issue : validator.issues()) {
+    switch (issue.type) {
+    case GamebryoLoadOrderValidator::Issue::Type::MissingMaster:
+      qWarning("%s: master %s is missing", qUtf8Printable(issue.plugin),
+               qUtf8Printable(issue.master));
+      break;
+    case GamebryoLoadOrderValidator::Issue::Type::MasterAfterDependent:
+      qWarning("%s: master %s loads after it", qUtf8Printable(issue.plugin),
+               qUtf8Printable(issue.master));
+      break;
+    case GamebryoLoadOrderValidator::Issue::Type::Cycle:
+      qWarning("%s: cyclic dependency on master %s", qUtf8Printable(issue.plugin),
+               qUtf8Printable(issue.master));
+      break;
+    }
+  }
+
+  return validator;
+}
+
+bool GamebryoGamePlugins::undoPluginListChange()
+{
+  const auto state = journal().undo();
+  if (!state) {
+    return false;
+  }
+
+  applyJournalState(*state);
+  return true;
+}
+
+bool GamebryoGamePlugins::redoPluginListChange()
+{
+  const auto state = journal().redo();
+  if (!state) {
+    return false;
+  }
+
+  applyJournalState(*state);
+  return true;
+}
+
+std::vector<GamebryoPluginListJournal::Record>
+GamebryoGamePlugins::pluginListChangesSince(const QDateTime& time)
+{
+  return journal().changesSince(time);
+}
+
+GamebryoPluginListJournal& GamebryoGamePlugins::journal()
+{
+  const QString filePath = organizer()->profilePath() + "/pluginlist.journal";
+  if (m_Journal.filePath() != filePath) {
+    m_Journal.open(filePath);
+  }
+
+  return m_Journal;
+}
+
+void GamebryoGamePlugins::applyJournalState(
+    const GamebryoPluginListJournal::State& state)
+{
+  IPluginList* pluginList = m_Organizer->pluginList();
+
+  QStringList loadOrder;
+  loadOrder.reserve(state.size());
+
+  GamebryoPluginStates states(pluginList);
+  for (const auto& line : state) {
+    loadOrder.append(line.name);
+    states.set(line.name, line.active ? IPluginList::STATE_ACTIVE
+                                      : IPluginList::STATE_INACTIVE);
+  }
+
+  pluginList->setLoadOrder(loadOrder);
+  states.apply();
+}
+
+GamebryoPluginHeaderCache& GamebryoGamePlugins::headerCache()
+{
+  if (!m_HeaderCacheLoaded) {
+    m_HeaderCache.load(headerCachePath());
+    m_HeaderCacheLoaded = true;
+  }
+
+  return m_HeaderCache;
+}
+
+QString GamebryoGamePlugins::headerCachePath() const
+{
+  return organizer()->basePath() + "/pluginheaders.cache";
 }
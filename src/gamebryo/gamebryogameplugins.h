@@ -1,11 +1,22 @@
 #ifndef GAMEBRYOGAMEPLUGINS_H
 #define GAMEBRYOGAMEPLUGINS_H
 
+#include "gamebryoloadordervalidator.h"
+#include "gamebryopluginheadercache.h"
+#include "gamebryopluginlistcache.h"
+#include "gamebryopluginlistjournal.h"
+#include "gamebryopluginlistsnapshot.h"
+
 #include <QDateTime>
 #include <QStringList>
 #include <gameplugins.h>
 #include <imoinfo.h>
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 class GamebryoGamePlugins : public MOBase::GamePlugins
 {
 public:
@@ -15,6 +26,61 @@ public:
   virtual void readPluginLists(MOBase::IPluginList* pluginList) override;
   virtual QStringList getLoadOrder() override;
 
+  /**
+   * @brief Returns the header of a plugin. Headers are cached and only read again when
+   * the plugin changes on disk.
+   *
+   * @param pluginName name of the plugin
+   * @return the header, or nullptr if the plugin could not be found or read
+   */
+  std::shared_ptr<const GamebryoPluginHeader> pluginHeader(const QString& pluginName);
+
+  /**
+   * @brief Returns the headers of many plugins, reading the ones that are not cached
+   * in parallel.
+   *
+   * @param pluginNames names of the plugins
+   * @return the headers, in the same order as the names
+   */
+  std::vector<std::shared_ptr<const GamebryoPluginHeader>>
+  pluginHeaders(const QStringList& pluginNames);
+
+  /**
+   * @return true if the plugin is light, either by flag or by extension
+   */
+  bool isLightPlugin(const QString& pluginName);
+
+  /**
+   * @brief Checks a load order against the masters of its plugins, taken from the
+   * plugin header cache.
+   *
+   * @param loadOrder plugins in load order, typically the result of getLoadOrder()
+   * @return a validator for the load order, which can be updated as plugins move
+   */
+  GamebryoLoadOrderValidator validateLoadOrder(const QStringList& loadOrder);
+
+  /**
+   * @brief Reverts the last change written to the plugin lists of the current profile
+   * and applies the previous load order and states to the plugin list.
+   *
+   * @return false if there is nothing to undo
+   */
+  bool undoPluginListChange();
+
+  /**
+   * @brief Applies the last undone change to the plugin list again.
+   *
+   * @return false if there is nothing to redo
+   */
+  bool redoPluginListChange();
+
+  /**
+   * @return the changes written to the plugin lists of the current profile after the
+   * given time, oldest first
+   */
+  std::vector<GamebryoPluginListJournal::Record>
+  pluginListChangesSince(const QDateTime& time);
+
 protected:
   MOBase::IOrganizer* organizer() const { return m_Organizer; }
 
@@ -22,6 +88,21 @@ protected:
                                const QString& filePath);
   virtual void writeLoadOrderList(const MOBase::IPluginList* pluginList,
                                   const QString& filePath);
+
+  /**
+   * @brief Writes plugins.txt or loadorder.txt from a snapshot of the plugin list.
+   *
+   * writePluginLists() takes a single snapshot and runs both of these concurrently,
+   * so they must not touch the plugin list or any state shared with the other one.
+   * Errors are not reported to the user from here since this may not be the main
+   * thread.
+   *
+   * @return false if some plugin names could not be encoded
+   */
+  virtual bool writePluginList(const GamebryoPluginListSnapshot& snapshot,
+                               const QString& filePath);
+  virtual bool writeLoadOrderList(const GamebryoPluginListSnapshot& snapshot,
+                                  const QString& filePath);
   virtual QStringList readLoadOrderList(MOBase::IPluginList* pluginList,
                                         const QString& filePath);
   virtual QStringList readPluginList(MOBase::IPluginList* pluginList);
@@ -39,16 +120,71 @@ protected:
    */
   QString getLoadOrderPath() const;
 
+  /**
+   * @brief Returns the absolute path of a plugin, inside the mod that provides it or
+   * the data directory of the game.
+   */
+  QString pluginPath(const MOBase::IPluginList* pluginList,
+                     const QString& pluginName) const;
+
+  /**
+   * @brief Returns the plugin lines of a plugins.txt or loadorder.txt file. Parsed
+   * files are cached, so switching back to a recent profile does not parse anything.
+   *
+   * @return the lines, or nullptr if the file is missing or could not be read
+   */
+  GamebryoPluginListCache::LinesPtr readListFile(const QString& filePath,
+                                                 QStringConverter::Encoding encoding);
+
+  /**
+   * @brief Writes a plugins.txt or loadorder.txt file if its content changed since
+   * the last save and caches its lines.
+   */
+  void commitListFile(GamebryoPluginListWriter& writer, const QString& filePath);
+
+  /**
+   * @brief Returns the hash of the content last saved to the given file. Safe to call
+   * from the writers running concurrently, the reference stays valid.
+   */
+  QByteArray& lastSaveHash(const QString& filePath);
+
+  /**
+   * @brief Tells the user that some plugin names could not be written.
+   */
+  static void reportInvalidNames();
+
 protected:
   MOBase::IOrganizer* m_Organizer;
   QDateTime m_LastRead;
 
 private:
-  void writeList(const MOBase::IPluginList* pluginList, const QString& filePath,
+  bool writeList(const GamebryoPluginListSnapshot& snapshot, const QString& filePath,
                  bool loadOrder);
 
+  /**
+   * @brief Sorts plugins by file time, reading each file time once. Plugins with the
+   * same file time keep the order of the last sort, or of loadorder.txt.
+   */
+  QStringList sortByFileTime(const MOBase::IPluginList* pluginList,
+                             const QStringList& plugins);
+
+  // the journal of the current profile, opened again when the profile changes
+  GamebryoPluginListJournal& journal();
+  void applyJournalState(const GamebryoPluginListJournal::State& state);
+
+  // the header cache, loaded from the instance directory on first use
+  GamebryoPluginHeaderCache& headerCache();
+  QString headerCachePath() const;
+
 private:
   std::map<QString, QByteArray> m_LastSaveHash;
+  std::mutex m_LastSaveHashMutex;
+  GamebryoPluginListCache m_ListCache;
+  GamebryoPluginListJournal m_Journal;
+
+  QStringList m_FileTimeOrder;
+  GamebryoPluginHeaderCache m_HeaderCache;
+  bool m_HeaderCacheLoaded;
 };
 
 #endif  // GAMEBRYOGAMEPLUGINS_H
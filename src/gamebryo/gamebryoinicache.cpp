@@ -0,0 +1,38 @@
+#include "gamebryoinicache.h"
+
+#include <QDir>
+
+GamebryoIniCache& GamebryoIniCache::instance()
+{
+  static GamebryoIniCache cache;
+  return cache;
+}
+
+QString GamebryoIniCache::key(const QString& filePath)
+{
+  return QDir::cleanPath(QDir::fromNativeSeparators(filePath)).toLower();
+}
+
+std::shared_ptr<GamebryoIniFile> GamebryoIniCache::file(const QString& filePath)
+{
+  std::scoped_lock lock(m_Mutex);
+
+  const QString fileKey = key(filePath);
+
+  auto it = m_Files.find(fileKey);
+  if (it != m_Files.end() && ((*it)->isDirty() || (*it)->isUpToDate())) {
+    return *it;
+  }
+
+  auto file = std::make_shared<GamebryoIniFile>(filePath);
+
+  // a file that could not be read is not shared, the next caller tries again
+  if (!file->load()) {
+    m_Files.remove(fileKey);
+    return file;
+  }
+
+  m_Files.insert(fileKey, file);
+
+  return file;
+}
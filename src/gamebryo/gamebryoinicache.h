@@ -0,0 +1,42 @@
+#ifndef GAMEBRYOINICACHE_H
+#define GAMEBRYOINICACHE_H
+
+#include "gamebryoinifile.h"
+
+#include <QHash>
+#include <QString>
+
+#include <memory>
+#include <mutex>
+
+/**
+ * @brief Parsed game INI files shared by the game features, keyed by path.
+ *
+ * A file is only parsed again when its size or modification time changes, so the
+ * features reading the same INI on launch or profile change share a single parse.
+ * Files with unsaved changes are kept as they are until their transaction saves them
+ * or drops them.
+ */
+class GamebryoIniCache
+{
+public:
+  static GamebryoIniCache& instance();
+
+  /**
+   * @brief Returns the parsed file, reading it if it is not cached or changed on disk.
+   * A missing file is returned empty and created when it is saved. A file that exists
+   * but could not be read is not cached and cannot be saved.
+   */
+  std::shared_ptr<GamebryoIniFile> file(const QString& filePath);
+
+private:
+  GamebryoIniCache() = default;
+
+  static QString key(const QString& filePath);
+
+private:
+  std::mutex m_Mutex;
+  QHash<QString, std::shared_ptr<GamebryoIniFile>> m_Files;
+};
+
+#endif  // GAMEBRYOINICACHE_H
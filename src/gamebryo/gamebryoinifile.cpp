@@ -0,0 +1,434 @@
+#include "gamebryoinifile.h"
+#include "gamebryowindows1252.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStringDecoder>
+
+#include <atomic>
+
+namespace
+{
+
+quint64 nextGeneration()
+{
+  static std::atomic<quint64> generation = 0;
+  return ++generation;
+}
+
+// splits "Section/Key" in its lowercase section and key, keys without a section are
+// the ones before the first section
+std::pair<QString, QString> splitKey(const QString& key)
+{
+  const qsizetype slash = key.indexOf('/');
+  if (slash < 0) {
+    return {QString(), key.trimmed()};
+  }
+
+  return {key.first(slash).trimmed().toLower(), key.sliced(slash + 1).trimmed()};
+}
+
+QString indexKey(const QString& section, const QString& key)
+{
+  return section + "/" + key.toLower();
+}
+
+}  // namespace
+
+GamebryoIniFile::GamebryoIniFile(const QString& filePath)
+    : m_FilePath(filePath), m_Exists(false), m_LoadFailed(false), m_Size(-1),
+      m_Windows1252(false), m_Bom(false), m_CarriageReturns(true),
+      m_TrailingNewline(true), m_Generation(nextGeneration())
+{}
+
+bool GamebryoIniFile::load()
+{
+  m_Lines.clear();
+  m_Pending.clear();
+  m_Content.clear();
+  m_Generation = nextGeneration();
+  m_LoadFailed = false;
+
+  m_Windows1252     = false;
+  m_Bom             = false;
+  m_CarriageReturns = true;
+  m_TrailingNewline = true;
+
+  const QFileInfo info(m_FilePath);
+  m_Exists       = info.exists();
+  m_Size         = info.size();
+  m_LastModified = info.lastModified();
+
+  if (!m_Exists) {
+    index();
+    return true;
+  }
+
+  QFile file(m_FilePath);
+  if (!file.open(QIODevice::ReadOnly)) {
+    qWarning("failed to open %s", qUtf8Printable(m_FilePath));
+    m_LoadFailed = true;
+    index();
+    return false;
+  }
+
+  QByteArray data = file.readAll();
+  file.close();
+
+  m_Content = data;
+
+  if (data.startsWith("\xEF\xBB\xBF")) {
+    m_Bom = true;
+    data.remove(0, 3);
+  }
+
+  // the games write their INI files in the ANSI code page, which is only valid UTF-8
+  // as long as it is plain ASCII; anything else is read as Windows-1252 whatever the
+  // local encoding is, like the paths in archives, so the bytes are written back as
+  // they were
+  QStringDecoder decoder(QStringConverter::Utf8, QStringConverter::Flag::Stateless);
+  QString text = decoder.decode(data);
+  if (decoder.hasError()) {
+    m_Windows1252 = true;
+    text          = decodeWindows1252(data);
+  }
+
+  parse(text);
+  index();
+
+  return true;
+}
+
+bool GamebryoIniFile::isUpToDate() const
+{
+  if (m_LoadFailed) {
+    return false;
+  }
+
+  const QFileInfo info(m_FilePath);
+  if (info.exists() != m_Exists) {
+    return false;
+  }
+
+  return !m_Exists ||
+         (info.size() == m_Size && info.lastModified() == m_LastModified);
+}
+
+void GamebryoIniFile::parse(const QString& text)
+{
+  QStringView remaining = text;
+
+  m_TrailingNewline = remaining.endsWith('\n');
+  if (m_TrailingNewline) {
+    remaining.chop(1);
+  }
+
+  if (remaining.isEmpty()) {
+    m_TrailingNewline = true;
+    return;
+  }
+
+  m_CarriageReturns = false;
+
+  QString section;
+  for (QStringView text : remaining.split('\n')) {
+    if (text.endsWith('\r')) {
+      m_CarriageReturns = true;
+      text.chop(1);
+    }
+
+    Line line;
+    line.text = text.toString();
+
+    const QStringView trimmed = text.trimmed();
+    if (trimmed.startsWith('[')) {
+      const qsizetype end = trimmed.indexOf(']');
+      if (end > 0) {
+        section        = trimmed.sliced(1, end - 1).trimmed().toString().toLower();
+        line.isSection = true;
+      }
+    }
+
+    line.section = section;
+
+    const qsizetype equals = text.indexOf('=');
+    if (!line.isSection && !trimmed.startsWith(';') && !trimmed.startsWith('#') &&
+        equals > 0) {
+      line.key = text.first(equals).trimmed().toString();
+
+      qsizetype start = equals + 1;
+      qsizetype end   = text.size();
+      while (start < end && text[start].isSpace()) {
+        ++start;
+      }
+      while (end > start && text[end - 1].isSpace()) {
+        --end;
+      }
+
+      line.valueStart = start;
+      line.valueEnd   = end;
+    }
+
+    m_Lines.push_back(std::move(line));
+  }
+}
+
+void GamebryoIniFile::index()
+{
+  m_Keys.clear();
+  m_SectionEnds.clear();
+
+  for (qsizetype i = 0; i < static_cast<qsizetype>(m_Lines.size()); ++i) {
+    const Line& line = m_Lines[i];
+
+    if (line.isSection) {
+      if (!m_SectionEnds.contains(line.section)) {
+        m_SectionEnds.insert(line.section, i);
+      }
+    } else if (!line.key.isEmpty()) {
+      m_SectionEnds.insert(line.section, i);
+
+      const QString key = indexKey(line.section, line.key);
+      if (!m_Keys.contains(key)) {
+        m_Keys.insert(key, i);
+      }
+    }
+  }
+}
+
+const GamebryoIniFile::Line* GamebryoIniFile::find(const QString& key) const
+{
+  const auto [section, name] = splitKey(key);
+
+  auto it = m_Keys.constFind(indexKey(section, name));
+  if (it == m_Keys.constEnd()) {
+    return nullptr;
+  }
+
+  return &m_Lines[*it];
+}
+
+bool GamebryoIniFile::contains(const QString& key) const
+{
+  return find(key) != nullptr;
+}
+
+QString GamebryoIniFile::value(const QString& key, const QString& defaultValue) const
+{
+  const Line* line = find(key);
+  if (line == nullptr) {
+    return defaultValue;
+  }
+
+  return line->text.sliced(line->valueStart, line->valueEnd - line->valueStart);
+}
+
+int GamebryoIniFile::intValue(const QString& key, int defaultValue) const
+{
+  bool ok         = false;
+  const int value = this->value(key).toInt(&ok);
+  return ok ? value : defaultValue;
+}
+
+bool GamebryoIniFile::boolValue(const QString& key, bool defaultValue) const
+{
+  const QString value = this->value(key);
+  if (value.compare("true", Qt::CaseInsensitive) == 0) {
+    return true;
+  } else if (value.compare("false", Qt::CaseInsensitive) == 0) {
+    return false;
+  }
+
+  return intValue(key, defaultValue ? 1 : 0) != 0;
+}
+
+void GamebryoIniFile::setValue(const QString& key, const QString& value)
+{
+  if (m_Windows1252 && !encodeWindows1252(value)) {
+    qWarning("cannot write \"%s\" to %s, it is not valid Windows-1252",
+             qUtf8Printable(value), qUtf8Printable(m_FilePath));
+    return;
+  }
+
+  Change change{key, value};
+  if (apply(change)) {
+    m_Pending.push_back(std::move(change));
+    m_Generation = nextGeneration();
+  }
+}
+
+void GamebryoIniFile::remove(const QString& key)
+{
+  Change change{key, std::nullopt};
+  if (apply(change)) {
+    m_Pending.push_back(std::move(change));
+    m_Generation = nextGeneration();
+  }
+}
+
+bool GamebryoIniFile::apply(const Change& change)
+{
+  const auto [section, name] = splitKey(change.key);
+  const QString key          = indexKey(section, name);
+
+  if (!change.value) {
+    const auto sizeBefore = m_Lines.size();
+    std::erase_if(m_Lines, [&](const Line& line) {
+      return !line.key.isEmpty() && indexKey(line.section, line.key) == key;
+    });
+
+    if (m_Lines.size() == sizeBefore) {
+      return false;
+    }
+
+    index();
+    return true;
+  }
+
+  const QString& value = *change.value;
+
+  auto it = m_Keys.constFind(key);
+  if (it != m_Keys.constEnd()) {
+    Line& line = m_Lines[*it];
+    if (QStringView(line.text).sliced(line.valueStart,
+                                      line.valueEnd - line.valueStart) == value) {
+      return false;
+    }
+
+    line.text.replace(line.valueStart, line.valueEnd - line.valueStart, value);
+    line.valueEnd = line.valueStart + value.size();
+    return true;
+  }
+
+  Line line;
+  line.text       = name + "=" + value;
+  line.section    = section;
+  line.key        = name;
+  line.valueStart = name.size() + 1;
+  line.valueEnd   = line.text.size();
+
+  auto end = m_SectionEnds.constFind(section);
+  if (end != m_SectionEnds.constEnd()) {
+    m_Lines.insert(m_Lines.begin() + *end + 1, std::move(line));
+  } else if (section.isEmpty()) {
+    m_Lines.insert(m_Lines.begin(), std::move(line));
+  } else {
+    // the section name is written in the case it was given in
+    Line header;
+    header.text      = "[" + change.key.first(change.key.indexOf('/')).trimmed() + "]";
+    header.section   = section;
+    header.isSection = true;
+
+    m_Lines.push_back(std::move(header));
+    m_Lines.push_back(std::move(line));
+  }
+
+  index();
+  return true;
+}
+
+std::optional<QByteArray> GamebryoIniFile::serialize() const
+{
+  const QString lineEnding = m_CarriageReturns ? "\r\n" : "\n";
+
+  QString text;
+  for (std::size_t i = 0; i < m_Lines.size(); ++i) {
+    if (i > 0) {
+      text += lineEnding;
+    }
+    text += m_Lines[i].text;
+  }
+
+  if (m_TrailingNewline && !m_Lines.empty()) {
+    text += lineEnding;
+  }
+
+  QByteArray result;
+  if (m_Bom) {
+    result = "\xEF\xBB\xBF";
+  }
+
+  if (m_Windows1252) {
+    const auto encoded = encodeWindows1252(text);
+    if (!encoded) {
+      return std::nullopt;
+    }
+    result += *encoded;
+  } else {
+    result += text.toUtf8();
+  }
+
+  return result;
+}
+
+bool GamebryoIniFile::save()
+{
+  if (m_Pending.empty()) {
+    return true;
+  }
+
+  // somebody else wrote the file, their changes are kept unless they set the same
+  // keys; this is also the case when the last load failed, only the changes are known
+  // then and writing them alone would lose the rest of the file
+  if (!isUpToDate()) {
+    GamebryoIniFile current(m_FilePath);
+    if (!current.load()) {
+      qWarning("not writing %s, it could not be read", qUtf8Printable(m_FilePath));
+      return false;
+    }
+
+    std::vector<Change> pending = std::move(m_Pending);
+    *this                       = std::move(current);
+
+    for (auto& change : pending) {
+      if (apply(change)) {
+        m_Pending.push_back(std::move(change));
+      }
+    }
+
+    if (m_Pending.empty()) {
+      return true;
+    }
+  }
+
+  // setValue() only checks the values against the encoding the file had back then,
+  // which changes if it was read again above
+  std::optional<QByteArray> serialized = serialize();
+  if (!serialized) {
+    qWarning("cannot write %s, the changes are not valid Windows-1252",
+             qUtf8Printable(m_FilePath));
+    return false;
+  }
+
+  // changes that cancel each other out leave the file alone
+  QByteArray data = std::move(*serialized);
+  if (data == m_Content) {
+    m_Pending.clear();
+    return true;
+  }
+
+  QDir().mkpath(QFileInfo(m_FilePath).absolutePath());
+
+  QSaveFile file(m_FilePath);
+  if (!file.open(QIODevice::WriteOnly)) {
+    qWarning("failed to open %s", qUtf8Printable(m_FilePath));
+    return false;
+  }
+
+  if (file.write(data) != data.size() || !file.commit()) {
+    qWarning("failed to write %s", qUtf8Printable(m_FilePath));
+    return false;
+  }
+
+  const QFileInfo info(m_FilePath);
+  m_Exists       = true;
+  m_Size         = info.size();
+  m_LastModified = info.lastModified();
+  m_Content      = std::move(data);
+
+  m_Pending.clear();
+
+  return true;
+}
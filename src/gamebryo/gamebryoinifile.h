@@ -0,0 +1,141 @@
+#ifndef GAMEBRYOINIFILE_H
+#define GAMEBRYOINIFILE_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+
+#include <optional>
+#include <vector>
+
+/**
+ * @brief Parsed game INI file that keeps the file as it is, so writing a value only
+ * changes the line of that value.
+ *
+ * Keys are given as "Section/Key" like with QSettings, but are matched
+ * case-insensitively and without any of the escaping QSettings does, which is how the
+ * games read them. When a key appears more than once, the first one is used, like
+ * GetPrivateProfileString() does.
+ *
+ * Changes are kept in memory until save() is called. If the file was changed by
+ * someone else in the meantime, it is read again and the changes are applied on top.
+ */
+class GamebryoIniFile
+{
+public:
+  GamebryoIniFile(const QString& filePath);
+
+  const QString& filePath() const { return m_FilePath; }
+
+  /**
+   * @brief Reads the file, dropping unsaved changes. A missing file is read as empty.
+   *
+   * @return false if the file exists but could not be read
+   */
+  bool load();
+
+  /**
+   * @return true if the file did not change on disk since it was loaded or saved, false
+   * if the last load failed
+   */
+  bool isUpToDate() const;
+
+  /**
+   * @return true if there are changes that were not saved yet
+   */
+  bool isDirty() const { return !m_Pending.empty(); }
+
+  /**
+   * @return a number that changes every time the content is read or changed, unique
+   * across files so that it can be used to tell whether a parsed value is current
+   */
+  quint64 generation() const { return m_Generation; }
+
+  bool contains(const QString& key) const;
+
+  QString value(const QString& key, const QString& defaultValue = {}) const;
+  int intValue(const QString& key, int defaultValue) const;
+  bool boolValue(const QString& key, bool defaultValue) const;
+
+  /**
+   * @brief Sets a value, adding the key and its section if needed. Setting a key to
+   * its current value is not a change. A value that cannot be encoded in the encoding
+   * of the file is not set.
+   */
+  void setValue(const QString& key, const QString& value);
+
+  /**
+   * @brief Removes every line that sets the key.
+   */
+  void remove(const QString& key);
+
+  /**
+   * @brief Writes the changes made since the last load or save, atomically. Does
+   * nothing if there are none or if they leave the content as it was.
+   *
+   * @return false if the file could not be written, or could not be read again after
+   * a failed load since writing only the changes would replace the rest of it
+   */
+  bool save();
+
+private:
+  struct Line
+  {
+    QString text;
+
+    // lowercase section the line belongs to, and key if the line sets a value
+    QString section;
+    QString key;
+
+    // position of the value in text
+    qsizetype valueStart = -1;
+    qsizetype valueEnd   = -1;
+
+    bool isSection = false;
+  };
+
+  struct Change
+  {
+    QString key;
+
+    // nullopt to remove the key
+    std::optional<QString> value;
+  };
+
+  void parse(const QString& text);
+  void index();
+  bool apply(const Change& change);
+  // nullopt if the content cannot be encoded in the encoding of the file
+  std::optional<QByteArray> serialize() const;
+
+  const Line* find(const QString& key) const;
+
+private:
+  QString m_FilePath;
+
+  bool m_Exists;
+  bool m_LoadFailed;
+  qint64 m_Size;
+  QDateTime m_LastModified;
+
+  // files that are not valid UTF-8 are in the ANSI code page of the game
+  bool m_Windows1252;
+  bool m_Bom;
+  bool m_CarriageReturns;
+  bool m_TrailingNewline;
+
+  // content of the file as last read or written
+  QByteArray m_Content;
+
+  std::vector<Line> m_Lines;
+
+  // line of each "section/key" and last line of each section, lowercase
+  QHash<QString, qsizetype> m_Keys;
+  QHash<QString, qsizetype> m_SectionEnds;
+
+  std::vector<Change> m_Pending;
+  quint64 m_Generation;
+};
+
+#endif  // GAMEBRYOINIFILE_H
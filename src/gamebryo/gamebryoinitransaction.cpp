@@ -0,0 +1,65 @@
+#include "gamebryoinitransaction.h"
+#include "gamebryoinicache.h"
+
+#include <algorithm>
+
+thread_local GamebryoIniTransaction::State* GamebryoIniTransaction::s_Current =
+    nullptr;
+
+GamebryoIniTransaction::GamebryoIniTransaction()
+    : m_Outermost(s_Current == nullptr), m_Committed(false)
+{
+  if (m_Outermost) {
+    s_Current = &m_State;
+  }
+}
+
+GamebryoIniTransaction::~GamebryoIniTransaction()
+{
+  if (!m_Outermost) {
+    return;
+  }
+
+  s_Current = nullptr;
+
+  if (!m_Committed) {
+    for (const auto& file : m_State.files) {
+      if (file->isDirty()) {
+        file->load();
+      }
+    }
+  }
+}
+
+std::shared_ptr<GamebryoIniFile> GamebryoIniTransaction::file(const QString& filePath)
+{
+  auto file = GamebryoIniCache::instance().file(filePath);
+
+  auto& files = s_Current->files;
+  if (std::find(files.begin(), files.end(), file) == files.end()) {
+    files.push_back(file);
+  }
+
+  return file;
+}
+
+bool GamebryoIniTransaction::commit()
+{
+  if (!m_Outermost) {
+    return true;
+  }
+
+  m_Committed = true;
+
+  bool success = true;
+  for (const auto& file : m_State.files) {
+    if (!file->save()) {
+      // the changes are dropped, otherwise the cache would keep handing out the
+      // unsaved file instead of what is on disk
+      file->load();
+      success = false;
+    }
+  }
+
+  return success;
+}
@@ -0,0 +1,60 @@
+#ifndef GAMEBRYOINITRANSACTION_H
+#define GAMEBRYOINITRANSACTION_H
+
+#include "gamebryoinifile.h"
+
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Groups changes to game INI files so that each file is written once.
+ *
+ * Files are taken from GamebryoIniCache and edited in memory. commit() then saves
+ * every file that was changed, each one atomically and only if its content is
+ * different. A transaction that ends without being committed drops its changes.
+ *
+ * A transaction created while another one is running on the same thread joins it:
+ * its files are saved when the outermost transaction commits. This lets
+ * GamebryoDataArchives stage its changes in the transaction of the feature that is
+ * preparing the profile.
+ */
+class GamebryoIniTransaction
+{
+public:
+  GamebryoIniTransaction();
+  ~GamebryoIniTransaction();
+
+  GamebryoIniTransaction(const GamebryoIniTransaction&)            = delete;
+  GamebryoIniTransaction& operator=(const GamebryoIniTransaction&) = delete;
+
+  /**
+   * @brief Returns a file to edit as part of the transaction.
+   */
+  std::shared_ptr<GamebryoIniFile> file(const QString& filePath);
+
+  /**
+   * @brief Saves the changed files, does nothing for a transaction that joined
+   * another one.
+   *
+   * @return false if a file could not be written, its changes are dropped and the
+   * other files are still saved
+   */
+  bool commit();
+
+private:
+  struct State
+  {
+    std::vector<std::shared_ptr<GamebryoIniFile>> files;
+  };
+
+  // transaction running on this thread, if any
+  static thread_local State* s_Current;
+
+  State m_State;
+  bool m_Outermost;
+  bool m_Committed;
+};
+
+#endif  // GAMEBRYOINITRANSACTION_H
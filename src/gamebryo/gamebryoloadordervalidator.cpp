@@ -0,0 +1,211 @@
+#include "gamebryoloadordervalidator.h"
+
+#include <algorithm>
+#include <numeric>
+
+void GamebryoLoadOrderValidator::setLoadOrder(const QStringList& loadOrder,
+                                              const std::vector<QStringList>& masters)
+{
+  const int count = static_cast<int>(loadOrder.size());
+
+  m_Names = loadOrder;
+  m_Index.clear();
+  m_Index.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    m_Index.insert(loadOrder[i], i);
+  }
+
+  m_Order.resize(count);
+  std::iota(m_Order.begin(), m_Order.end(), 0);
+  m_Position = m_Order;
+
+  m_Masters.assign(count, {});
+  m_Dependents.assign(count, {});
+  m_MissingMasters.assign(count, {});
+  m_LateMasters.assign(count, {});
+
+  for (int i = 0; i < count && i < static_cast<int>(masters.size()); ++i) {
+    for (const QString& master : masters[i]) {
+      auto it = m_Index.constFind(master);
+      if (it == m_Index.constEnd()) {
+        m_MissingMasters[i].append(master);
+      } else {
+        m_Masters[i].push_back(*it);
+        m_Dependents[*it].push_back(i);
+      }
+    }
+  }
+
+  for (int i = 0; i < count; ++i) {
+    checkOrder(i);
+  }
+
+  findCycles();
+}
+
+void GamebryoLoadOrderValidator::movePlugin(qsizetype from, qsizetype to)
+{
+  const qsizetype count = static_cast<qsizetype>(m_Order.size());
+  if (from < 0 || from >= count || to < 0 || to >= count || from == to) {
+    return;
+  }
+
+  const int plugin = m_Order[from];
+  m_Order.erase(m_Order.begin() + from);
+  m_Order.insert(m_Order.begin() + to, plugin);
+
+  for (qsizetype i = std::min(from, to); i <= std::max(from, to); ++i) {
+    m_Position[m_Order[i]] = static_cast<int>(i);
+  }
+
+  // plugins in between only shifted by one relative to each other, so only pairs
+  // that include the moved plugin can have changed
+  checkOrder(plugin);
+  for (int dependent : m_Dependents[plugin]) {
+    checkOrder(dependent);
+  }
+}
+
+QStringList GamebryoLoadOrderValidator::loadOrder() const
+{
+  QStringList result;
+  result.reserve(m_Order.size());
+  for (int plugin : m_Order) {
+    result.append(m_Names[plugin]);
+  }
+  return result;
+}
+
+std::vector<GamebryoLoadOrderValidator::Issue>
+GamebryoLoadOrderValidator::issues() const
+{
+  std::vector<Issue> result;
+
+  for (int plugin : m_Order) {
+    const QString& name = m_Names[plugin];
+
+    for (const QString& master : m_MissingMasters[plugin]) {
+      result.push_back({Issue::Type::MissingMaster, name, master});
+    }
+
+    for (int master : m_LateMasters[plugin]) {
+      result.push_back({Issue::Type::MasterAfterDependent, name, m_Names[master]});
+    }
+
+    if (m_InCycle[plugin]) {
+      for (int master : m_Masters[plugin]) {
+        if (m_Component[master] == m_Component[plugin]) {
+          result.push_back({Issue::Type::Cycle, name, m_Names[master]});
+        }
+      }
+    }
+  }
+
+  return result;
+}
+
+bool GamebryoLoadOrderValidator::isValid() const
+{
+  for (int plugin : m_Order) {
+    if (!m_MissingMasters[plugin].isEmpty() || !m_LateMasters[plugin].empty() ||
+        m_InCycle[plugin]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void GamebryoLoadOrderValidator::checkOrder(int plugin)
+{
+  auto& late = m_LateMasters[plugin];
+  late.clear();
+
+  for (int master : m_Masters[plugin]) {
+    if (m_Position[master] > m_Position[plugin]) {
+      late.push_back(master);
+    }
+  }
+}
+
+void GamebryoLoadOrderValidator::findCycles()
+{
+  // iterative Tarjan, load orders can be deep enough to overflow the stack with
+  // recursion
+  const int count = static_cast<int>(m_Masters.size());
+
+  std::vector<int> index(count, -1), lowLink(count, 0);
+  std::vector<bool> onStack(count, false);
+  std::vector<int> stack;
+  int nextIndex     = 0;
+  int nextComponent = 0;
+
+  m_Component.assign(count, -1);
+  m_InCycle.assign(count, false);
+
+  struct Frame
+  {
+    int plugin;
+    std::size_t edge;
+  };
+  std::vector<Frame> frames;
+
+  auto visit = [&](int plugin) {
+    index[plugin] = lowLink[plugin] = nextIndex++;
+    stack.push_back(plugin);
+    onStack[plugin] = true;
+    frames.push_back({plugin, 0});
+  };
+
+  for (int root = 0; root < count; ++root) {
+    if (index[root] != -1) {
+      continue;
+    }
+
+    visit(root);
+
+    while (!frames.empty()) {
+      const int plugin = frames.back().plugin;
+      const auto& edges = m_Masters[plugin];
+
+      if (frames.back().edge < edges.size()) {
+        const int master = edges[frames.back().edge++];
+        if (index[master] == -1) {
+          visit(master);
+        } else if (onStack[master]) {
+          lowLink[plugin] = std::min(lowLink[plugin], index[master]);
+        }
+        continue;
+      }
+
+      frames.pop_back();
+      if (!frames.empty()) {
+        const int parent = frames.back().plugin;
+        lowLink[parent]  = std::min(lowLink[parent], lowLink[plugin]);
+      }
+
+      if (lowLink[plugin] == index[plugin]) {
+        std::vector<int> members;
+        int member;
+        do {
+          member = stack.back();
+          stack.pop_back();
+          onStack[member]     = false;
+          m_Component[member] = nextComponent;
+          members.push_back(member);
+        } while (member != plugin);
+
+        // a single plugin is only a cycle if it is its own master
+        const bool cycle =
+            members.size() > 1 ||
+            std::find(m_Masters[plugin].begin(), m_Masters[plugin].end(), plugin) !=
+                m_Masters[plugin].end();
+        for (int m : members) {
+          m_InCycle[m] = cycle;
+        }
+
+        ++nextComponent;
+      }
+    }
+  }
+}
@@ -0,0 +1,105 @@
+#ifndef GAMEBRYOLOADORDERVALIDATOR_H
+#define GAMEBRYOLOADORDERVALIDATOR_H
+
+#include "gamebryopluginname.h"
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+
+/**
+ * @brief Checks a load order against the masters of its plugins.
+ *
+ * The masters form a dependency graph that is built once per load order. Validation
+ * is linear in the number of plugins and masters, and moving a single plugin only
+ * re-checks that plugin and the plugins that depend on it.
+ */
+class GamebryoLoadOrderValidator
+{
+public:
+  struct Issue
+  {
+    enum class Type
+    {
+      // the master is not in the load order
+      MissingMaster,
+
+      // the master loads after the plugin
+      MasterAfterDependent,
+
+      // the plugin and the master depend on each other, directly or not
+      Cycle
+    };
+
+    Type type;
+    QString plugin;
+    QString master;
+  };
+
+  /**
+   * @brief Sets the load order to validate.
+   *
+   * @param loadOrder plugins in load order
+   * @param masters masters of every plugin, in the same order as loadOrder
+   */
+  void setLoadOrder(const QStringList& loadOrder,
+                    const std::vector<QStringList>& masters);
+
+  /**
+   * @brief Moves a plugin to another position in the load order and re-validates the
+   * plugins affected by the move.
+   *
+   * @param from current position of the plugin
+   * @param to new position of the plugin
+   */
+  void movePlugin(qsizetype from, qsizetype to);
+
+  /**
+   * @return the current load order
+   */
+  QStringList loadOrder() const;
+
+  /**
+   * @return all issues of the current load order, sorted by the position of the
+   * plugin they concern
+   */
+  std::vector<Issue> issues() const;
+
+  /**
+   * @return true if the current load order has no issue
+   */
+  bool isValid() const;
+
+private:
+  // re-checks the position of a plugin against its masters
+  void checkOrder(int plugin);
+
+  // finds the strongly connected components of the dependency graph
+  void findCycles();
+
+private:
+  QStringList m_Names;
+
+  // plugin name -> plugin
+  QHash<GamebryoPluginName, int> m_Index;
+
+  // plugins are identified by their position in the initial load order, these map
+  // between plugins and their current position
+  std::vector<int> m_Order;
+  std::vector<int> m_Position;
+
+  // dependency graph, in both directions
+  std::vector<std::vector<int>> m_Masters;
+  std::vector<std::vector<int>> m_Dependents;
+
+  std::vector<QStringList> m_MissingMasters;
+  std::vector<std::vector<int>> m_LateMasters;
+
+  // strongly connected component of every plugin
+  std::vector<int> m_Component;
+  std::vector<bool> m_InCycle;
+};
+
+#endif  // GAMEBRYOLOADORDERVALIDATOR_H
@@ -24,6 +24,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <stddef.h>
 #include <string>
 
+#include "gamebryoinitransaction.h"
 #include "gamegamebryo.h"
 
 using namespace Qt::Literals::StringLiterals;
@@ -64,7 +65,8 @@ bool GamebryoLocalSavegames::prepareProfile(MOBase::IProfile* profile)
   QString iniFilePath     = basePath + "/" + m_IniFileName;
   QString saveIniFilePath = profile->absolutePath() + "/" + "savepath.ini";
 
-  QSettings ini(iniFilePath, QSettings::IniFormat);
+  GamebryoIniTransaction transaction;
+  auto ini = transaction.file(iniFilePath);
 
   static const QString skipMe   = u"SKIP_ME"_s;
   static const QString deleteMe = u"DELETE_ME"_s;
@@ -73,12 +75,12 @@ bool GamebryoLocalSavegames::prepareProfile(MOBase::IProfile* profile)
   static const QString bUseMyGamesDirectory = u"General/bUseMyGamesDirectory"_s;
 
   // Get the current sLocalSavePath
-  QString currentPath = ini.value(sLocalSavePath, skipMe).toString();
+  QString currentPath = ini->value(sLocalSavePath, skipMe);
 
   bool alreadyEnabled = currentPath == localSavesDummy();
 
   // Get the current bUseMyGamesDirectory
-  QString currentMyGames = ini.value(bUseMyGamesDirectory, skipMe).toString();
+  QString currentMyGames = ini->value(bUseMyGamesDirectory, skipMe);
   // Create the __MO_Saves directory if local saves are enabled and it doesn't exist
   if (enable) {
     QDir saves = localSavesDirectory();
@@ -99,8 +101,8 @@ bool GamebryoLocalSavegames::prepareProfile(MOBase::IProfile* profile)
       saveIni.setValue(bUseMyGamesDirectory, currentMyGames);
     }
 
-    ini.setValue(sLocalSavePath, localSavesDummy());
-    ini.setValue(bUseMyGamesDirectory, u"1"_s);
+    ini->setValue(sLocalSavePath, localSavesDummy());
+    ini->setValue(bUseMyGamesDirectory, u"1"_s);
   }
 
   // Get rid of the local saves setting if it's still there
@@ -112,23 +114,27 @@ bool GamebryoLocalSavegames::prepareProfile(MOBase::IProfile* profile)
       QString savedMyGames = saveIni.value(bUseMyGamesDirectory, deleteMe).toString();
 
       if (savedPath != deleteMe) {
-        ini.setValue(sLocalSavePath, savedPath);
+        ini->setValue(sLocalSavePath, savedPath);
       } else {
-        ini.remove(sLocalSavePath);
+        ini->remove(sLocalSavePath);
       }
       if (savedMyGames != deleteMe) {
-        ini.setValue(bUseMyGamesDirectory, savedMyGames);
+        ini->setValue(bUseMyGamesDirectory, savedMyGames);
       } else {
-        ini.remove(bUseMyGamesDirectory);
+        ini->remove(bUseMyGamesDirectory);
       }
       QFile::remove(saveIniFilePath);
     }
     // Otherwise just delete the setting
     else {
-      ini.remove(sLocalSavePath);
-      ini.remove(bUseMyGamesDirectory);
+      ini->remove(sLocalSavePath);
+      ini->remove(bUseMyGamesDirectory);
     }
   }
 
+  if (!transaction.commit()) {
+    qWarning("failed to set the save path in \"%s\"", qUtf8Printable(m_IniFileName));
+  }
+
   return enable != alreadyEnabled;
 }
@@ -0,0 +1,56 @@
+#ifndef GAMEBRYOPARALLEL_H
+#define GAMEBRYOPARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Calls func(i) for every i in [0, count) on a set of worker threads, the
+ * calling thread included.
+ *
+ * Indices are handed out one at a time, so uneven work is balanced across threads.
+ * Returns once every call is done. func must not throw.
+ *
+ * @param count number of items
+ * @param func function to call for every item
+ * @param maxThreads maximum number of threads to use, 0 for one per core
+ */
+template <typename Func>
+void parallelFor(std::size_t count, Func&& func, std::size_t maxThreads = 0)
+{
+  std::size_t threads =
+      maxThreads != 0 ? maxThreads
+                      : std::max<std::size_t>(1, std::thread::hardware_concurrency());
+  threads = std::min(threads, count);
+
+  if (threads <= 1) {
+    for (std::size_t i = 0; i < count; ++i) {
+      func(i);
+    }
+    return;
+  }
+
+  std::atomic<std::size_t> next = 0;
+  auto worker                   = [&]() {
+    for (std::size_t i = next++; i < count; i = next++) {
+      func(i);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  for (std::size_t i = 1; i < threads; ++i) {
+    pool.emplace_back(worker);
+  }
+
+  worker();
+
+  for (auto& thread : pool) {
+    thread.join();
+  }
+}
+
+#endif  // GAMEBRYOPARALLEL_H
@@ -0,0 +1,241 @@
+#include "gamebryopluginheader.h"
+#include "gamebryobytecursor.h"
+#include "gamebryoparallel.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+
+#include <zlib.h>
+
+#include <stdexcept>
+
+namespace
+{
+
+QString readZString(QByteArrayView data)
+{
+  const qsizetype end = data.indexOf('\0');
+  return QString::fromLocal8Bit(end < 0 ? data : data.first(end));
+}
+
+}  // namespace
+
+GamebryoPluginHeader GamebryoPluginHeader::read(const QString& filePath,
+                                                bool computeCrc)
+{
+  QFile file(filePath);
+  if (!file.open(QIODevice::ReadOnly)) {
+    throw std::runtime_error(
+        QObject::tr("failed to open %1").arg(filePath).toUtf8().constData());
+  }
+
+  const QString fileName = QFileInfo(filePath).fileName();
+
+  // the header is at the start of the file, mapping avoids reading anything else
+  const qint64 size = file.size();
+  if (uchar* data = file.map(0, size)) {
+    try {
+      GamebryoPluginHeader header = parse(fileName, QByteArrayView(data, size));
+      if (computeCrc) {
+        header.m_Crc = crc32_z(crc32_z(0, nullptr, 0), data, size);
+      }
+      file.unmap(data);
+      return header;
+    } catch (...) {
+      file.unmap(data);
+      throw;
+    }
+  }
+
+  // header records are small, 64 KiB is plenty for all but the largest master lists
+  QByteArray buffer           = file.read(std::min<qint64>(size, 0x10000));
+  GamebryoPluginHeader header = parse(fileName, buffer);
+
+  if (computeCrc) {
+    uLong crc = crc32_z(0, nullptr, 0);
+    while (!buffer.isEmpty()) {
+      crc    = crc32_z(crc, reinterpret_cast<const Bytef*>(buffer.constData()),
+                       buffer.size());
+      buffer = file.read(0x100000);
+    }
+    header.m_Crc = crc;
+  }
+
+  return header;
+}
+
+GamebryoPluginHeader GamebryoPluginHeader::parse(const QString& fileName,
+                                                 QByteArrayView data)
+{
+  GamebryoPluginHeader header;
+  header.m_FileName = fileName;
+
+  if (data.startsWith("TES4")) {
+    parseTES4(header, data);
+  } else if (data.startsWith("TES3")) {
+    parseTES3(header, data);
+  } else {
+    throw std::runtime_error(
+        QObject::tr("%1 is not a plugin").arg(fileName).toUtf8().constData());
+  }
+
+  return header;
+}
+
+void GamebryoPluginHeader::parseTES4(GamebryoPluginHeader& header, QByteArrayView data)
+{
+  header.m_Format = Format::TES4;
+
+  GamebryoByteCursor cursor(data);
+  cursor.take(4);  // TES4
+  const auto dataSize = cursor.read<uint32_t>();
+  header.m_Flags      = cursor.read<uint32_t>();
+  cursor.take(8);  // form id, version control info
+
+  // Oblivion uses 20 byte record headers, later games add 4 bytes of version info;
+  // the first subrecord is always HEDR
+  if (!data.sliced(20).startsWith("HEDR")) {
+    if (data.size() < 28 || !data.sliced(24).startsWith("HEDR")) {
+      throw std::runtime_error("invalid TES4 record");
+    }
+    cursor.take(4);
+  }
+
+  GamebryoByteCursor record(cursor.take(dataSize));
+  uint32_t nextSize = 0;
+
+  while (!record.atEnd()) {
+    const QByteArrayView type = record.take(4);
+    uint32_t size             = record.read<uint16_t>();
+
+    // XXXX holds the size of the next subrecord if it doesn't fit in 16 bits
+    if (nextSize != 0) {
+      size     = nextSize;
+      nextSize = 0;
+    }
+
+    const QByteArrayView content = record.take(size);
+
+    if (type == "XXXX") {
+      nextSize = GamebryoByteCursor(content).read<uint32_t>();
+    } else if (type == "HEDR") {
+      GamebryoByteCursor hedr(content);
+      header.m_Version      = hedr.read<float>();
+      header.m_RecordCount  = hedr.read<uint32_t>();
+      header.m_NextObjectId = hedr.read<uint32_t>();
+    } else if (type == "CNAM") {
+      header.m_Author = readZString(content);
+    } else if (type == "SNAM") {
+      header.m_Description = readZString(content);
+    } else if (type == "MAST") {
+      header.m_Masters.append(readZString(content));
+    }
+  }
+}
+
+void GamebryoPluginHeader::parseTES3(GamebryoPluginHeader& header, QByteArrayView data)
+{
+  header.m_Format = Format::TES3;
+
+  GamebryoByteCursor cursor(data);
+  cursor.take(4);  // TES3
+  const auto dataSize = cursor.read<uint32_t>();
+  cursor.take(4);  // unused
+  header.m_Flags = cursor.read<uint32_t>();
+
+  GamebryoByteCursor record(cursor.take(dataSize));
+
+  while (!record.atEnd()) {
+    const QByteArrayView type    = record.take(4);
+    const uint32_t size          = record.read<uint32_t>();
+    const QByteArrayView content = record.take(size);
+
+    if (type == "HEDR") {
+      GamebryoByteCursor hedr(content);
+      header.m_Version = hedr.read<float>();
+      if (hedr.read<uint32_t>() == 1) {
+        header.m_Flags |= FLAG_MASTER;
+      }
+      header.m_Author      = readZString(hedr.take(32));
+      header.m_Description = readZString(hedr.take(256));
+      header.m_RecordCount = hedr.read<uint32_t>();
+    } else if (type == "MAST") {
+      header.m_Masters.append(readZString(content));
+    }
+  }
+}
+
+std::vector<std::optional<GamebryoPluginHeader>>
+GamebryoPluginHeader::readAll(const QStringList& filePaths)
+{
+  std::vector<std::optional<GamebryoPluginHeader>> headers(filePaths.size());
+
+  parallelFor(filePaths.size(), [&](std::size_t i) {
+    try {
+      headers[i] = read(filePaths[i]);
+    } catch (const std::exception& e) {
+      qWarning("failed to read plugin header: %s", e.what());
+    }
+  });
+
+  return headers;
+}
+
+std::vector<GamebryoPluginHeader>
+GamebryoPluginHeader::scanDirectory(const QString& directory)
+{
+  const QDir dir(directory);
+
+  QStringList filePaths;
+  for (const QString& fileName :
+       dir.entryList({"*.esp", "*.esm", "*.esl"}, QDir::Files)) {
+    filePaths.append(dir.absoluteFilePath(fileName));
+  }
+
+  std::vector<GamebryoPluginHeader> result;
+  for (auto& header : readAll(filePaths)) {
+    if (header) {
+      result.push_back(std::move(*header));
+    }
+  }
+
+  return result;
+}
+
+bool GamebryoPluginHeader::isLightFlagged(bool mediumPluginsSupported) const
+{
+  // Starfield moved the light flag to make room for the update flag
+  return (m_Flags & (mediumPluginsSupported ? FLAG_SMALL : FLAG_LIGHT)) != 0;
+}
+
+bool GamebryoPluginHeader::isMaster() const
+{
+  return isMasterFlagged() || m_FileName.endsWith(".esm", Qt::CaseInsensitive) ||
+         m_FileName.endsWith(".esl", Qt::CaseInsensitive);
+}
+
+bool GamebryoPluginHeader::isLight(bool mediumPluginsSupported) const
+{
+  return isLightFlagged(mediumPluginsSupported) ||
+         m_FileName.endsWith(".esl", Qt::CaseInsensitive);
+}
+
+QDataStream& operator<<(QDataStream& stream, const GamebryoPluginHeader& header)
+{
+  return stream << header.m_FileName << static_cast<quint8>(header.m_Format)
+                << header.m_Flags << header.m_Version << header.m_RecordCount
+                << header.m_NextObjectId << header.m_Author << header.m_Description
+                << header.m_Masters << header.m_Crc;
+}
+
+QDataStream& operator>>(QDataStream& stream, GamebryoPluginHeader& header)
+{
+  quint8 format;
+  stream >> header.m_FileName >> format >> header.m_Flags >> header.m_Version >>
+      header.m_RecordCount >> header.m_NextObjectId >> header.m_Author >>
+      header.m_Description >> header.m_Masters >> header.m_Crc;
+  header.m_Format = static_cast<GamebryoPluginHeader::Format>(format);
+  return stream;
+}
@@ -0,0 +1,134 @@
+#ifndef GAMEBRYOPLUGINHEADER_H
+#define GAMEBRYOPLUGINHEADER_H
+
+#include <QByteArrayView>
+#include <QDataStream>
+#include <QString>
+#include <QStringList>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief Header of a plugin file (.esp, .esm or .esl).
+ *
+ * Only the header record (TES4, or TES3 for Morrowind) is parsed, the rest of the
+ * file is never read.
+ */
+class GamebryoPluginHeader
+{
+public:
+  enum Flags : uint32_t
+  {
+    FLAG_MASTER    = 0x00000001,
+    FLAG_LOCALIZED = 0x00000080,
+
+    // light flag used by Skyrim SE and Fallout 4
+    FLAG_LIGHT = 0x00000200,
+
+    // flags used by Starfield
+    FLAG_SMALL  = 0x00000100,
+    FLAG_MEDIUM = 0x00000400
+  };
+
+  enum class Format
+  {
+    TES3,
+    TES4
+  };
+
+  /**
+   * @brief Reads the header of a plugin.
+   *
+   * @param filePath path of the plugin
+   * @param computeCrc whether to compute the CRC of the whole file, which reads all
+   * of it
+   * @throws std::runtime_error if the file cannot be read or is not a plugin
+   **/
+  static GamebryoPluginHeader read(const QString& filePath, bool computeCrc = false);
+
+  /**
+   * @brief Parses the header of a plugin from its content. Only the beginning of the
+   * file is needed.
+   *
+   * @param fileName name of the plugin
+   * @param data content of the plugin
+   * @throws std::runtime_error if the content is not a valid plugin header
+   **/
+  static GamebryoPluginHeader parse(const QString& fileName, QByteArrayView data);
+
+  /**
+   * @brief Reads the headers of many plugins in parallel.
+   *
+   * @param filePaths paths of the plugins
+   * @return the headers, in the same order as the paths. Plugins that could not be
+   * read are logged and left empty.
+   **/
+  static std::vector<std::optional<GamebryoPluginHeader>>
+  readAll(const QStringList& filePaths);
+
+  /**
+   * @brief Reads the headers of all plugins in a directory in parallel.
+   *
+   * @param directory the directory to scan, typically a data directory
+   * @return the headers of all plugins that could be read
+   **/
+  static std::vector<GamebryoPluginHeader> scanDirectory(const QString& directory);
+
+  GamebryoPluginHeader() = default;
+
+  const QString& fileName() const { return m_FileName; }
+  Format format() const { return m_Format; }
+  uint32_t flags() const { return m_Flags; }
+  float version() const { return m_Version; }
+  uint32_t recordCount() const { return m_RecordCount; }
+  uint32_t nextObjectId() const { return m_NextObjectId; }
+  const QString& author() const { return m_Author; }
+  const QString& description() const { return m_Description; }
+  const QStringList& masters() const { return m_Masters; }
+
+  // CRC32 of the whole file, 0 if it was not computed
+  uint32_t crc() const { return m_Crc; }
+
+  bool isMasterFlagged() const { return (m_Flags & FLAG_MASTER) != 0; }
+
+  /**
+   * @param mediumPluginsSupported whether the game supports medium plugins, which
+   * changes the flag used for light plugins
+   */
+  bool isLightFlagged(bool mediumPluginsSupported) const;
+  bool isMediumFlagged() const { return (m_Flags & FLAG_MEDIUM) != 0; }
+
+  /**
+   * @return true if the plugin is a master, either by flag or by extension
+   */
+  bool isMaster() const;
+
+  /**
+   * @return true if the plugin is light, either by flag or by extension
+   */
+  bool isLight(bool mediumPluginsSupported) const;
+
+private:
+  static void parseTES3(GamebryoPluginHeader& header, QByteArrayView data);
+  static void parseTES4(GamebryoPluginHeader& header, QByteArrayView data);
+
+  friend QDataStream& operator<<(QDataStream& stream,
+                                 const GamebryoPluginHeader& header);
+  friend QDataStream& operator>>(QDataStream& stream, GamebryoPluginHeader& header);
+
+private:
+  QString m_FileName;
+  Format m_Format         = Format::TES4;
+  uint32_t m_Flags        = 0;
+  float m_Version         = 0.0f;
+  uint32_t m_RecordCount  = 0;
+  uint32_t m_NextObjectId = 0;
+  QString m_Author;
+  QString m_Description;
+  QStringList m_Masters;
+  uint32_t m_Crc = 0;
+};
+
+#endif  // GAMEBRYOPLUGINHEADER_H
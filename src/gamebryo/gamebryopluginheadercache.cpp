@@ -0,0 +1,162 @@
+#include "gamebryopluginheadercache.h"
+#include "gamebryoparallel.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+namespace
+{
+
+// "MOPH"
+constexpr quint32 CACHE_MAGIC   = 0x4d4f5048;
+constexpr quint32 CACHE_VERSION = 1;
+
+}  // namespace
+
+GamebryoPluginHeaderCache::GamebryoPluginHeaderCache(bool computeCrc)
+    : m_ComputeCrc(computeCrc), m_Dirty(false)
+{}
+
+GamebryoPluginHeaderCache::HeaderPtr
+GamebryoPluginHeaderCache::header(const QString& filePath)
+{
+  const QFileInfo info(filePath);
+  if (!info.exists()) {
+    return nullptr;
+  }
+
+  const qint64 size            = info.size();
+  const QDateTime lastModified = info.lastModified();
+
+  {
+    std::scoped_lock lock(m_Mutex);
+    auto it = m_Entries.constFind(filePath);
+    if (it != m_Entries.constEnd() && it->size == size &&
+        it->lastModified == lastModified) {
+      return it->header;
+    }
+  }
+
+  // read outside of the lock so other plugins can be read at the same time
+  HeaderPtr result;
+  try {
+    result = std::make_shared<const GamebryoPluginHeader>(
+        GamebryoPluginHeader::read(filePath, m_ComputeCrc));
+  } catch (const std::exception& e) {
+    qWarning("failed to read plugin header: %s", e.what());
+  }
+
+  std::scoped_lock lock(m_Mutex);
+  m_Entries.insert(filePath, {size, lastModified, result});
+  m_Dirty = true;
+
+  return result;
+}
+
+std::vector<GamebryoPluginHeaderCache::HeaderPtr>
+GamebryoPluginHeaderCache::headers(const QStringList& filePaths)
+{
+  std::vector<HeaderPtr> result(filePaths.size());
+
+  parallelFor(filePaths.size(), [&](std::size_t i) {
+    result[i] = header(filePaths[i]);
+  });
+
+  return result;
+}
+
+void GamebryoPluginHeaderCache::clear()
+{
+  std::scoped_lock lock(m_Mutex);
+  m_Entries.clear();
+  m_Dirty = true;
+}
+
+bool GamebryoPluginHeaderCache::load(const QString& filePath)
+{
+  QFile file(filePath);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_6_0);
+
+  quint32 magic, version, count;
+  stream >> magic >> version >> count;
+  if (stream.status() != QDataStream::Ok || magic != CACHE_MAGIC ||
+      version != CACHE_VERSION) {
+    qWarning("ignoring invalid plugin header cache %s", qUtf8Printable(filePath));
+    return false;
+  }
+
+  QHash<QString, Entry> entries;
+  entries.reserve(count);
+
+  for (quint32 i = 0; i < count; ++i) {
+    QString path;
+    qint64 size, lastModified;
+    bool hasHeader;
+    stream >> path >> size >> lastModified >> hasHeader;
+
+    HeaderPtr header;
+    if (hasHeader) {
+      auto h = std::make_shared<GamebryoPluginHeader>();
+      stream >> *h;
+      header = std::move(h);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+      qWarning("ignoring invalid plugin header cache %s", qUtf8Printable(filePath));
+      return false;
+    }
+
+    entries.insert(path, {size, QDateTime::fromMSecsSinceEpoch(lastModified),
+                          std::move(header)});
+  }
+
+  std::scoped_lock lock(m_Mutex);
+  m_Entries = std::move(entries);
+  m_Dirty   = false;
+
+  return true;
+}
+
+bool GamebryoPluginHeaderCache::save(const QString& filePath)
+{
+  std::scoped_lock lock(m_Mutex);
+
+  if (!m_Dirty) {
+    return true;
+  }
+
+  QSaveFile file(filePath);
+  if (!file.open(QIODevice::WriteOnly)) {
+    qWarning("failed to open %s", qUtf8Printable(filePath));
+    return false;
+  }
+
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_6_0);
+
+  stream << CACHE_MAGIC << CACHE_VERSION << static_cast<quint32>(m_Entries.size());
+
+  for (auto it = m_Entries.cbegin(); it != m_Entries.cend(); ++it) {
+    stream << it.key() << it->size << it->lastModified.toMSecsSinceEpoch()
+           << (it->header != nullptr);
+    if (it->header) {
+      stream << *it->header;
+    }
+  }
+
+  if (stream.status() != QDataStream::Ok || !file.commit()) {
+    qWarning("failed to write %s", qUtf8Printable(filePath));
+    return false;
+  }
+
+  m_Dirty = false;
+
+  return true;
+}
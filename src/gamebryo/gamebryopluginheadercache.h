@@ -0,0 +1,93 @@
+#ifndef GAMEBRYOPLUGINHEADERCACHE_H
+#define GAMEBRYOPLUGINHEADERCACHE_H
+
+#include "gamebryopluginheader.h"
+
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Cache of plugin headers, keyed by path. A plugin is read again only when its
+ * size or modification time changes.
+ *
+ * The cache can be saved to and loaded from a compact binary file, so that headers
+ * survive restarts and plugins that did not change are never opened.
+ */
+class GamebryoPluginHeaderCache
+{
+public:
+  using HeaderPtr = std::shared_ptr<const GamebryoPluginHeader>;
+
+  /**
+   * @param computeCrc whether to compute the CRC of plugins when reading them, which
+   * reads the whole file instead of only the header
+   */
+  GamebryoPluginHeaderCache(bool computeCrc = false);
+
+  /**
+   * @brief Returns the header of a plugin, reading it if it is not cached or changed.
+   *
+   * @param filePath path of the plugin
+   * @return the header, or nullptr if the plugin could not be read
+   */
+  HeaderPtr header(const QString& filePath);
+
+  /**
+   * @brief Returns the headers of many plugins. Plugins that are not cached or changed
+   * are read in parallel.
+   *
+   * @param filePaths paths of the plugins
+   * @return the headers, in the same order as the paths. Plugins that could not be
+   * read are nullptr.
+   */
+  std::vector<HeaderPtr> headers(const QStringList& filePaths);
+
+  /**
+   * @brief Removes all entries from the cache.
+   */
+  void clear();
+
+  /**
+   * @brief Replaces the content of the cache with the entries saved in a file. Loaded
+   * entries are still checked against the size and modification time of plugins.
+   *
+   * @param filePath path of the cache file
+   * @return false if the file does not exist or is invalid
+   */
+  bool load(const QString& filePath);
+
+  /**
+   * @brief Saves the cache to a file if it changed since it was last loaded or saved.
+   *
+   * @param filePath path of the cache file
+   * @return false if the file could not be written
+   */
+  bool save(const QString& filePath);
+
+private:
+  struct Entry
+  {
+    qint64 size;
+    QDateTime lastModified;
+
+    // nullptr for plugins that could not be read, so they are not retried until
+    // they change
+    HeaderPtr header;
+  };
+
+  bool m_ComputeCrc;
+
+  std::mutex m_Mutex;
+  QHash<QString, Entry> m_Entries;
+
+  // whether entries changed since the cache was last loaded or saved
+  bool m_Dirty;
+};
+
+#endif  // GAMEBRYOPLUGINHEADERCACHE_H
@@ -0,0 +1,83 @@
+#include "gamebryopluginlistcache.h"
+
+#include <QFileInfo>
+
+#include <utility>
+
+GamebryoPluginListCache::GamebryoPluginListCache(std::size_t capacity)
+    : m_Capacity(capacity)
+{}
+
+GamebryoPluginListCache::LinesPtr
+GamebryoPluginListCache::read(const QString& filePath,
+                              QStringConverter::Encoding encoding)
+{
+  const QFileInfo info(filePath);
+  if (!info.exists()) {
+    return nullptr;
+  }
+
+  const qint64 size            = info.size();
+  const QDateTime lastModified = info.lastModified();
+
+  {
+    std::scoped_lock lock(m_Mutex);
+    for (auto it = m_Entries.begin(); it != m_Entries.end(); ++it) {
+      if (it->filePath == filePath) {
+        if (it->size == size && it->lastModified == lastModified) {
+          m_Entries.splice(m_Entries.begin(), m_Entries, it);
+          return it->lines;
+        }
+        break;
+      }
+    }
+  }
+
+  GamebryoPluginListReader reader(encoding);
+  if (!reader.read(filePath)) {
+    return nullptr;
+  }
+
+  std::vector<GamebryoPluginListLine> lines;
+  lines.reserve(reader.entries().size());
+  for (const auto& entry : reader.entries()) {
+    lines.push_back({entry.name.toString(), entry.active});
+  }
+
+  auto result = std::make_shared<const std::vector<GamebryoPluginListLine>>(
+      std::move(lines));
+
+  std::scoped_lock lock(m_Mutex);
+  insert({filePath, size, lastModified, result});
+
+  return result;
+}
+
+void GamebryoPluginListCache::store(const QString& filePath,
+                                    std::vector<GamebryoPluginListLine> lines)
+{
+  const QFileInfo info(filePath);
+
+  std::scoped_lock lock(m_Mutex);
+  insert({filePath, info.size(), info.lastModified(),
+          std::make_shared<const std::vector<GamebryoPluginListLine>>(
+              std::move(lines))});
+}
+
+void GamebryoPluginListCache::clear()
+{
+  std::scoped_lock lock(m_Mutex);
+  m_Entries.clear();
+}
+
+void GamebryoPluginListCache::insert(Entry entry)
+{
+  m_Entries.remove_if([&](const Entry& e) {
+    return e.filePath == entry.filePath;
+  });
+
+  m_Entries.push_front(std::move(entry));
+  while (m_Entries.size() > m_Capacity) {
+    m_Entries.pop_back();
+  }
+}
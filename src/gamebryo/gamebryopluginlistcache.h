@@ -0,0 +1,73 @@
+#ifndef GAMEBRYOPLUGINLISTCACHE_H
+#define GAMEBRYOPLUGINLISTCACHE_H
+
+#include "gamebryopluginlistfile.h"
+
+#include <QDateTime>
+#include <QString>
+#include <QStringConverter>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Bounded cache of parsed plugins.txt and loadorder.txt files, keyed by path.
+ *
+ * Files are only parsed again when their size or modification time changes, and
+ * files written by MO are stored as they are written. Since the files live in the
+ * profile directory, switching back to a recently used profile does not parse
+ * anything. The least recently used files are dropped first.
+ */
+class GamebryoPluginListCache
+{
+public:
+  using LinesPtr = std::shared_ptr<const std::vector<GamebryoPluginListLine>>;
+
+  /**
+   * @param capacity maximum number of files to keep, two per profile
+   */
+  GamebryoPluginListCache(std::size_t capacity = 16);
+
+  /**
+   * @brief Returns the plugin lines of a file, parsing it if it is not cached or
+   * changed.
+   *
+   * @param filePath path of the file
+   * @param encoding encoding of the file
+   * @return the lines, or nullptr if the file is missing or could not be read
+   */
+  LinesPtr read(const QString& filePath, QStringConverter::Encoding encoding);
+
+  /**
+   * @brief Stores the lines that were just written to a file.
+   */
+  void store(const QString& filePath, std::vector<GamebryoPluginListLine> lines);
+
+  /**
+   * @brief Removes all entries from the cache.
+   */
+  void clear();
+
+private:
+  struct Entry
+  {
+    QString filePath;
+    qint64 size;
+    QDateTime lastModified;
+    LinesPtr lines;
+  };
+
+  void insert(Entry entry);
+
+private:
+  std::size_t m_Capacity;
+
+  std::mutex m_Mutex;
+
+  // most recently used first
+  std::list<Entry> m_Entries;
+};
+
+#endif  // GAMEBRYOPLUGINLISTCACHE_H
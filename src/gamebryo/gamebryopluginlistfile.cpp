@@ -0,0 +1,132 @@
+#include "gamebryopluginlistfile.h"
+
+#include <QByteArrayView>
+#include <QFile>
+#include <QStringDecoder>
+#include <safewritefile.h>
+
+using MOBase::SafeWriteFile;
+
+GamebryoPluginListReader::GamebryoPluginListReader(QStringConverter::Encoding encoding)
+    : m_Encoding(encoding)
+{}
+
+bool GamebryoPluginListReader::read(const QString& filePath)
+{
+  m_Text.clear();
+  m_Entries.clear();
+
+  QFile file(filePath);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  const qint64 size = file.size();
+  if (size == 0) {
+    return true;
+  }
+
+  QStringDecoder decoder(m_Encoding);
+  if (uchar* data = file.map(0, size)) {
+    m_Text = decoder.decode(QByteArrayView(data, size));
+    file.unmap(data);
+  } else {
+    m_Text = decoder.decode(file.readAll());
+  }
+
+  parse();
+
+  return true;
+}
+
+void GamebryoPluginListReader::parse()
+{
+  const QStringView text(m_Text);
+
+  // both searches below are vectorized by Qt
+  m_Entries.reserve(text.count(u'\n') + 1);
+
+  qsizetype pos = 0;
+  while (pos < text.size()) {
+    qsizetype end = text.indexOf(u'\n', pos);
+    if (end < 0) {
+      end = text.size();
+    }
+
+    QStringView line = text.sliced(pos, end - pos).trimmed();
+    pos              = end + 1;
+
+    if (line.isEmpty() || line.startsWith(u'#')) {
+      continue;
+    }
+
+    const bool active = line.startsWith(u'*');
+    if (active) {
+      line = line.sliced(1);
+      if (line.isEmpty()) {
+        continue;
+      }
+    }
+
+    m_Entries.push_back({line, active});
+  }
+}
+
+GamebryoPluginListWriter::GamebryoPluginListWriter(QStringConverter::Encoding encoding)
+    : m_Encoder(encoding), m_Hash(QCryptographicHash::Md5), m_Count(0),
+      m_InvalidNames(false)
+{}
+
+void GamebryoPluginListWriter::append(QByteArrayView data)
+{
+  m_Buffer.append(data);
+  m_Hash.addData(data);
+}
+
+void GamebryoPluginListWriter::addComment(QStringView comment)
+{
+  const QByteArray result = m_Encoder.encode(comment);
+  append("# ");
+  append(result);
+  append("\r\n");
+}
+
+void GamebryoPluginListWriter::addPlugin(QStringView pluginName, bool activeMarker)
+{
+  const QByteArray result = m_Encoder.encode(pluginName);
+  if (m_Encoder.hasError()) {
+    m_InvalidNames = true;
+    qCritical("invalid plugin name %s", qUtf8Printable(pluginName.toString()));
+
+    // the error state is sticky, start over for the next name
+    m_Encoder.resetState();
+  } else {
+    if (activeMarker) {
+      append("*");
+    }
+    append(result);
+    m_Lines.push_back({pluginName.toString(), activeMarker});
+  }
+  append("\r\n");
+  ++m_Count;
+}
+
+bool GamebryoPluginListWriter::commitIfDifferent(const QString& filePath,
+                                                 QByteArray& lastHash)
+{
+  QByteArray hash = m_Hash.result();
+  if (hash == lastHash && QFile::exists(filePath)) {
+    return false;
+  }
+
+  SafeWriteFile file(filePath);
+  file->resize(0);
+  if (file->write(m_Buffer) != m_Buffer.size()) {
+    qCritical("failed to write %s", qUtf8Printable(filePath));
+    return false;
+  }
+  file.commit();
+
+  lastHash = std::move(hash);
+  return true;
+}
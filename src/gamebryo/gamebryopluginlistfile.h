@@ -0,0 +1,119 @@
+#ifndef GAMEBRYOPLUGINLISTFILE_H
+#define GAMEBRYOPLUGINLISTFILE_H
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QString>
+#include <QStringConverter>
+#include <QStringEncoder>
+#include <QStringView>
+
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A plugin line of a plugins.txt or loadorder.txt file, owning its name.
+ */
+struct GamebryoPluginListLine
+{
+  QString name;
+  bool active;
+};
+
+/**
+ * @brief Parser for plugins.txt and loadorder.txt files.
+ *
+ * The whole file is mapped (or read) once and decoded with a single decoder. Entries
+ * are views into the decoded text and stay valid for the lifetime of the reader.
+ */
+class GamebryoPluginListReader
+{
+public:
+  struct Entry
+  {
+    // name of the plugin, without the leading '*'
+    QStringView name;
+
+    // whether the line was prefixed with '*', which marks active plugins in the
+    // plugins.txt of Creation engine games
+    bool active;
+  };
+
+  GamebryoPluginListReader(QStringConverter::Encoding encoding);
+
+  /**
+   * @brief Reads and parses the specified file. Comments and empty lines are skipped
+   * and every other line is trimmed.
+   *
+   * @param filePath path of the file to read
+   * @return false if the file could not be opened, an empty file has no entries
+   */
+  bool read(const QString& filePath);
+
+  const std::vector<Entry>& entries() const { return m_Entries; }
+
+private:
+  void parse();
+
+private:
+  QStringConverter::Encoding m_Encoding;
+  QString m_Text;
+  std::vector<Entry> m_Entries;
+};
+
+/**
+ * @brief Builds a plugins.txt or loadorder.txt file in memory.
+ *
+ * Lines are encoded into a buffer and hashed as they are added, so the file on disk
+ * is only touched if its content differs from the last save.
+ */
+class GamebryoPluginListWriter
+{
+public:
+  GamebryoPluginListWriter(QStringConverter::Encoding encoding);
+
+  /**
+   * @brief Adds a comment line, typically the header of the file.
+   */
+  void addComment(QStringView comment);
+
+  /**
+   * @brief Adds a line for the given plugin. Names that cannot be encoded are logged
+   * and written as empty lines.
+   *
+   * @param pluginName name of the plugin
+   * @param activeMarker whether to prefix the name with '*'
+   */
+  void addPlugin(QStringView pluginName, bool activeMarker = false);
+
+  // number of plugin lines added so far
+  int count() const { return m_Count; }
+
+  // whether some plugin names could not be encoded
+  bool hasInvalidNames() const { return m_InvalidNames; }
+
+  // plugin lines added so far, as they will be read back from the file
+  std::vector<GamebryoPluginListLine> takeLines() { return std::move(m_Lines); }
+
+  /**
+   * @brief Writes the file, unless it exists and its content has the given hash.
+   *
+   * @param filePath path of the file to write
+   * @param lastHash hash of the last saved content, updated if the file is written
+   * @return true if the file was written
+   */
+  bool commitIfDifferent(const QString& filePath, QByteArray& lastHash);
+
+private:
+  void append(QByteArrayView data);
+
+private:
+  QStringEncoder m_Encoder;
+  QByteArray m_Buffer;
+  QCryptographicHash m_Hash;
+  std::vector<GamebryoPluginListLine> m_Lines;
+  int m_Count;
+  bool m_InvalidNames;
+};
+
+#endif  // GAMEBRYOPLUGINLISTFILE_H
@@ -0,0 +1,484 @@
+#include "gamebryopluginlistjournal.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QHash>
+#include <QSaveFile>
+#include <QTimeZone>
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+
+// "MOPJ"
+constexpr quint32 JOURNAL_MAGIC   = 0x4d4f504a;
+constexpr quint32 JOURNAL_VERSION = 2;
+
+// journals with more records are compacted when they are opened
+constexpr std::size_t COMPACT_THRESHOLD = 256;
+
+constexpr quint8 CHANGE_OLD_ACTIVE = 0x1;
+constexpr quint8 CHANGE_NEW_ACTIVE = 0x2;
+constexpr quint8 CHANGE_MOVED      = 0x4;
+
+// marks the elements of a longest strictly increasing subsequence of values
+std::vector<bool> longestIncreasingSubsequence(const std::vector<qint32>& values)
+{
+  // tails[k] is the index of the smallest value ending a subsequence of length k + 1
+  std::vector<std::size_t> tails;
+  std::vector<std::size_t> previous(values.size());
+
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    auto it = std::lower_bound(tails.begin(), tails.end(), values[i],
+                               [&](std::size_t tail, qint32 value) {
+                                 return values[tail] < value;
+                               });
+
+    previous[i] = it == tails.begin() ? i : *(it - 1);
+    if (it == tails.end()) {
+      tails.push_back(i);
+    } else {
+      *it = i;
+    }
+  }
+
+  std::vector<bool> result(values.size(), false);
+  if (!tails.empty()) {
+    std::size_t i = tails.back();
+    for (;;) {
+      result[i] = true;
+      if (previous[i] == i) {
+        break;
+      }
+      i = previous[i];
+    }
+  }
+
+  return result;
+}
+
+}  // namespace
+
+bool GamebryoPluginListJournal::open(const QString& filePath)
+{
+  m_FilePath = filePath;
+  m_State.clear();
+  m_Records.clear();
+  m_Undo.clear();
+  m_Redo.clear();
+
+  QFile file(filePath);
+  if (!file.exists()) {
+    return true;
+  }
+
+  if (!file.open(QIODevice::ReadOnly)) {
+    qWarning("failed to open %s", qUtf8Printable(filePath));
+    return false;
+  }
+
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_6_0);
+
+  quint32 magic, version;
+  stream >> magic >> version;
+  if (stream.status() != QDataStream::Ok || magic != JOURNAL_MAGIC ||
+      version != JOURNAL_VERSION) {
+    // records must not be appended to a file that cannot be read back
+    qWarning("discarding invalid plugin list journal %s", qUtf8Printable(filePath));
+    file.close();
+    QFile::remove(filePath);
+    return false;
+  }
+
+  bool truncated = false;
+  while (!stream.atEnd()) {
+    QByteArray data;
+    stream >> data;
+
+    Record record;
+    State next;
+    if (stream.status() != QDataStream::Ok || !deserialize(data, record) ||
+        (record.kind == KIND_BASE) != m_Records.empty() ||
+        !apply(m_State, record, next)) {
+      qWarning("plugin list journal %s is truncated after %d records",
+               qUtf8Printable(filePath), static_cast<int>(m_Records.size()));
+      truncated = true;
+      break;
+    }
+
+    m_State = std::move(next);
+    m_Records.push_back(std::move(record));
+
+    if (!track(m_Records.size() - 1)) {
+      qWarning("plugin list journal %s has an undo or redo without a change",
+               qUtf8Printable(filePath));
+      m_Undo.clear();
+      m_Redo.clear();
+    }
+  }
+
+  file.close();
+
+  // a truncated journal is rewritten so that new records can be read back
+  if (truncated || m_Records.size() > COMPACT_THRESHOLD) {
+    compact();
+  }
+
+  return true;
+}
+
+bool GamebryoPluginListJournal::compact()
+{
+  Record base = diff({}, m_State);
+  base.time   = QDateTime::currentDateTimeUtc();
+  base.kind   = KIND_BASE;
+
+  QSaveFile file(m_FilePath);
+  if (!file.open(QIODevice::WriteOnly)) {
+    qWarning("failed to open %s", qUtf8Printable(m_FilePath));
+    return false;
+  }
+
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_6_0);
+  stream << JOURNAL_MAGIC << JOURNAL_VERSION << serialize(base);
+
+  if (stream.status() != QDataStream::Ok || !file.commit()) {
+    qWarning("failed to write %s", qUtf8Printable(m_FilePath));
+    return false;
+  }
+
+  m_Records.assign(1, std::move(base));
+  m_Undo.clear();
+  m_Redo.clear();
+
+  return true;
+}
+
+bool GamebryoPluginListJournal::track(std::size_t index)
+{
+  switch (m_Records[index].kind) {
+  case KIND_BASE:
+    m_Undo.clear();
+    m_Redo.clear();
+    return true;
+
+  case KIND_CHANGE:
+    m_Undo.push_back(index);
+    m_Redo.clear();
+    return true;
+
+  case KIND_UNDO:
+    if (m_Undo.empty()) {
+      return false;
+    }
+    m_Redo.push_back(m_Undo.back());
+    m_Undo.pop_back();
+    return true;
+
+  case KIND_REDO:
+    if (m_Redo.empty()) {
+      return false;
+    }
+    m_Undo.push_back(m_Redo.back());
+    m_Redo.pop_back();
+    return true;
+  }
+
+  return false;
+}
+
+bool GamebryoPluginListJournal::record(const State& state)
+{
+  Record record = diff(m_State, state);
+  if (record.changes.empty()) {
+    return false;
+  }
+
+  record.kind = m_Records.empty() ? KIND_BASE : KIND_CHANGE;
+  if (!append(std::move(record))) {
+    return false;
+  }
+
+  return track(m_Records.size() - 1);
+}
+
+std::optional<GamebryoPluginListJournal::State> GamebryoPluginListJournal::undo()
+{
+  if (m_Undo.empty()) {
+    return {};
+  }
+
+  Record record = inverse(m_Records[m_Undo.back()]);
+  record.kind   = KIND_UNDO;
+  if (!append(std::move(record))) {
+    return {};
+  }
+
+  track(m_Records.size() - 1);
+
+  return m_State;
+}
+
+std::optional<GamebryoPluginListJournal::State> GamebryoPluginListJournal::redo()
+{
+  if (m_Redo.empty()) {
+    return {};
+  }
+
+  Record record = m_Records[m_Redo.back()];
+  record.kind   = KIND_REDO;
+  if (!append(std::move(record))) {
+    return {};
+  }
+
+  track(m_Records.size() - 1);
+
+  return m_State;
+}
+
+std::vector<GamebryoPluginListJournal::Record>
+GamebryoPluginListJournal::changesSince(const QDateTime& time) const
+{
+  auto it = std::upper_bound(m_Records.begin(), m_Records.end(), time,
+                             [](const QDateTime& time, const Record& record) {
+                               return time < record.time;
+                             });
+
+  return {it, m_Records.end()};
+}
+
+bool GamebryoPluginListJournal::append(Record record)
+{
+  State next;
+  if (!apply(m_State, record, next)) {
+    return false;
+  }
+
+  record.time = QDateTime::currentDateTimeUtc();
+
+  QFile file(m_FilePath);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+    qWarning("failed to open %s", qUtf8Printable(m_FilePath));
+    return false;
+  }
+
+  // build the whole record first so it is appended with a single write
+  QByteArray buffer;
+  QDataStream stream(&buffer, QIODevice::WriteOnly);
+  stream.setVersion(QDataStream::Qt_6_0);
+
+  if (file.size() == 0) {
+    stream << JOURNAL_MAGIC << JOURNAL_VERSION;
+  }
+  stream << serialize(record);
+
+  if (file.write(buffer) != buffer.size()) {
+    qWarning("failed to write %s", qUtf8Printable(m_FilePath));
+    return false;
+  }
+
+  m_State = std::move(next);
+  m_Records.push_back(std::move(record));
+
+  return true;
+}
+
+GamebryoPluginListJournal::Record GamebryoPluginListJournal::diff(const State& from,
+                                                                  const State& to)
+{
+  Record record;
+
+  QHash<QString, qint32> fromIndex;
+  fromIndex.reserve(from.size());
+  for (qint32 i = 0; i < static_cast<qint32>(from.size()); ++i) {
+    fromIndex.insert(from[i].name, i);
+  }
+
+  // positions in the old list of the plugins that are in both, in their new order
+  std::vector<qint32> kept;
+  std::vector<bool> present(from.size(), false);
+  kept.reserve(to.size());
+  for (const auto& line : to) {
+    auto it = fromIndex.constFind(line.name);
+    if (it != fromIndex.constEnd()) {
+      kept.push_back(*it);
+      present[*it] = true;
+    }
+  }
+
+  // plugins that are part of the longest run that kept its order did not move
+  const std::vector<bool> stable = longestIncreasingSubsequence(kept);
+
+  std::size_t k = 0;
+  for (qint32 j = 0; j < static_cast<qint32>(to.size()); ++j) {
+    const auto& line = to[j];
+    auto it          = fromIndex.constFind(line.name);
+
+    if (it == fromIndex.constEnd()) {
+      record.changes.push_back({line.name, -1, j, false, line.active, false});
+      continue;
+    }
+
+    const qint32 i   = *it;
+    const bool moved = !stable[k++];
+    if (moved || from[i].active != line.active) {
+      record.changes.push_back({line.name, i, j, from[i].active, line.active, moved});
+    }
+  }
+
+  for (qint32 i = 0; i < static_cast<qint32>(from.size()); ++i) {
+    if (!present[i]) {
+      record.changes.push_back({from[i].name, i, -1, from[i].active, false, false});
+    }
+  }
+
+  return record;
+}
+
+GamebryoPluginListJournal::Record
+GamebryoPluginListJournal::inverse(const Record& record)
+{
+  Record result;
+  result.changes.reserve(record.changes.size());
+
+  for (const auto& change : record.changes) {
+    result.changes.push_back({change.name, change.newIndex, change.oldIndex,
+                              change.newActive, change.oldActive, change.moved});
+  }
+
+  return result;
+}
+
+bool GamebryoPluginListJournal::apply(const State& from, const Record& record,
+                                      State& to)
+{
+  const auto fromSize = static_cast<qint32>(from.size());
+
+  qint32 added = 0, removed = 0;
+  for (const auto& change : record.changes) {
+    if (change.isAdded()) {
+      ++added;
+    } else if (change.isRemoved()) {
+      ++removed;
+    }
+  }
+
+  const qint32 toSize = fromSize - removed + added;
+  if (toSize < 0) {
+    return false;
+  }
+
+  // changes by position in the old list, and positions of the new list that are
+  // taken by added and moved plugins
+  std::vector<const Change*> bySource(fromSize, nullptr);
+  std::vector<bool> placed(toSize, false);
+
+  to.assign(toSize, {});
+
+  for (const auto& change : record.changes) {
+    if (change.oldIndex >= fromSize || change.newIndex >= toSize ||
+        (change.isAdded() && change.isRemoved())) {
+      return false;
+    }
+
+    if (!change.isAdded()) {
+      if (from[change.oldIndex].name != change.name) {
+        return false;
+      }
+      bySource[change.oldIndex] = &change;
+    }
+
+    if (!change.isRemoved() && (change.isAdded() || change.moved)) {
+      if (placed[change.newIndex]) {
+        return false;
+      }
+      to[change.newIndex]     = {change.name, change.newActive};
+      placed[change.newIndex] = true;
+    }
+  }
+
+  // everything else keeps its relative order and fills the remaining positions
+  qint32 next = 0;
+  for (qint32 i = 0; i < fromSize; ++i) {
+    const Change* change = bySource[i];
+    if (change != nullptr && (change->isRemoved() || change->moved)) {
+      continue;
+    }
+
+    while (next < toSize && placed[next]) {
+      ++next;
+    }
+    if (next == toSize) {
+      return false;
+    }
+
+    to[next++] = {from[i].name, change != nullptr ? change->newActive : from[i].active};
+  }
+
+  return true;
+}
+
+QByteArray GamebryoPluginListJournal::serialize(const Record& record)
+{
+  QByteArray result;
+  QDataStream stream(&result, QIODevice::WriteOnly);
+  stream.setVersion(QDataStream::Qt_6_0);
+
+  stream << record.time.toMSecsSinceEpoch() << static_cast<quint8>(record.kind)
+         << static_cast<quint32>(record.changes.size());
+
+  for (const auto& change : record.changes) {
+    quint8 flags = 0;
+    if (change.oldActive) {
+      flags |= CHANGE_OLD_ACTIVE;
+    }
+    if (change.newActive) {
+      flags |= CHANGE_NEW_ACTIVE;
+    }
+    if (change.moved) {
+      flags |= CHANGE_MOVED;
+    }
+
+    stream << change.name << change.oldIndex << change.newIndex << flags;
+  }
+
+  return result;
+}
+
+bool GamebryoPluginListJournal::deserialize(const QByteArray& data, Record& record)
+{
+  QDataStream stream(data);
+  stream.setVersion(QDataStream::Qt_6_0);
+
+  qint64 time;
+  quint8 kind;
+  quint32 count;
+  stream >> time >> kind >> count;
+  if (stream.status() != QDataStream::Ok || kind > KIND_REDO) {
+    return false;
+  }
+
+  record.time = QDateTime::fromMSecsSinceEpoch(time, QTimeZone::UTC);
+  record.kind = static_cast<Kind>(kind);
+  record.changes.clear();
+
+  for (quint32 i = 0; i < count; ++i) {
+    Change change;
+    quint8 flags;
+    stream >> change.name >> change.oldIndex >> change.newIndex >> flags;
+    if (stream.status() != QDataStream::Ok) {
+      return false;
+    }
+
+    change.oldActive = (flags & CHANGE_OLD_ACTIVE) != 0;
+    change.newActive = (flags & CHANGE_NEW_ACTIVE) != 0;
+    change.moved     = (flags & CHANGE_MOVED) != 0;
+    record.changes.push_back(std::move(change));
+  }
+
+  return true;
+}
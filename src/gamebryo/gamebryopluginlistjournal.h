@@ -0,0 +1,148 @@
+#ifndef GAMEBRYOPLUGINLISTJOURNAL_H
+#define GAMEBRYOPLUGINLISTJOURNAL_H
+
+#include "gamebryopluginlistfile.h"
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+
+#include <optional>
+#include <vector>
+
+/**
+ * @brief Append-only journal of the changes made to a plugin list.
+ *
+ * Every record holds the difference between two consecutive states of the list
+ * (plugins in load order with their active flag): plugins that were added, removed,
+ * moved or enabled/disabled. Only plugins outside of the longest run that kept its
+ * relative order are recorded as moved, so moving one plugin records one change.
+ *
+ * The first record of a journal holds the full list. Records are appended to the
+ * file as they are made and can be applied in either direction, which gives undo and
+ * redo without storing copies of the list. Undo and redo are recorded as such, so the
+ * undo and redo stacks are rebuilt when the journal is opened again.
+ *
+ * Once a journal holds too many records, opening it replaces it with a single record
+ * of the current list, which also drops the changes that could be undone.
+ */
+class GamebryoPluginListJournal
+{
+public:
+  using State = std::vector<GamebryoPluginListLine>;
+
+  struct Change
+  {
+    QString name;
+
+    // position before and after the change, -1 if the plugin was added or removed
+    qint32 oldIndex;
+    qint32 newIndex;
+
+    bool oldActive;
+    bool newActive;
+
+    // whether the plugin left the order of the plugins around it
+    bool moved;
+
+    bool isAdded() const { return oldIndex < 0; }
+    bool isRemoved() const { return newIndex < 0; }
+  };
+
+  enum Kind : quint8
+  {
+    // the full list, first record of a journal
+    KIND_BASE,
+
+    // a change made to the list
+    KIND_CHANGE,
+
+    // the inverse of the last change that was not undone yet
+    KIND_UNDO,
+
+    // the last undone change, applied again
+    KIND_REDO
+  };
+
+  struct Record
+  {
+    QDateTime time;
+    Kind kind = KIND_CHANGE;
+    std::vector<Change> changes;
+  };
+
+  /**
+   * @brief Opens a journal and replays it to get the current state. The file is
+   * created on the first record if it does not exist.
+   *
+   * @param filePath path of the journal
+   * @return false if the file exists but could not be read, the journal is empty in
+   * that case. A truncated last record, from a crash for example, is dropped.
+   */
+  bool open(const QString& filePath);
+
+  /**
+   * @brief Replaces the journal with a single record of the current state.
+   *
+   * @return false if the file could not be written
+   */
+  bool compact();
+
+  const QString& filePath() const { return m_FilePath; }
+
+  /**
+   * @return the state after the last record
+   */
+  const State& state() const { return m_State; }
+
+  /**
+   * @brief Records the difference between the current state and the given one.
+   *
+   * @return true if something changed and the record was appended
+   */
+  bool record(const State& state);
+
+  /**
+   * @brief Reverts the last change that was not undone yet, by appending its inverse.
+   *
+   * @return the new state, or nothing if there is nothing to undo
+   */
+  std::optional<State> undo();
+
+  /**
+   * @brief Applies the last undone change again. Recording a new change clears the
+   * changes that can be redone.
+   *
+   * @return the new state, or nothing if there is nothing to redo
+   */
+  std::optional<State> redo();
+
+  /**
+   * @return the records made after the given time, oldest first
+   */
+  std::vector<Record> changesSince(const QDateTime& time) const;
+
+private:
+  static Record diff(const State& from, const State& to);
+  static Record inverse(const Record& record);
+  static bool apply(const State& from, const Record& record, State& to);
+
+  static QByteArray serialize(const Record& record);
+  static bool deserialize(const QByteArray& data, Record& record);
+
+  bool append(Record record);
+
+  // updates the undo and redo stacks for a record that was just added
+  bool track(std::size_t index);
+
+private:
+  QString m_FilePath;
+  State m_State;
+  std::vector<Record> m_Records;
+
+  // indices in m_Records of the changes that can be undone and redone
+  std::vector<std::size_t> m_Undo;
+  std::vector<std::size_t> m_Redo;
+};
+
+#endif  // GAMEBRYOPLUGINLISTJOURNAL_H
@@ -0,0 +1,30 @@
+#include "gamebryopluginlistsnapshot.h"
+
+#include <QStringList>
+
+#include <algorithm>
+#include <utility>
+
+using MOBase::IPluginList;
+
+GamebryoPluginListSnapshot::GamebryoPluginListSnapshot(const IPluginList* pluginList)
+{
+  const QStringList pluginNames = pluginList->pluginNames();
+
+  // priorities are fetched once instead of twice per comparison
+  std::vector<std::pair<int, Plugin>> plugins;
+  plugins.reserve(pluginNames.size());
+  for (const QString& pluginName : pluginNames) {
+    plugins.push_back({pluginList->priority(pluginName),
+                       {pluginName, pluginList->state(pluginName)}});
+  }
+
+  std::sort(plugins.begin(), plugins.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.first < rhs.first;
+  });
+
+  m_Plugins.reserve(plugins.size());
+  for (auto& plugin : plugins) {
+    m_Plugins.push_back(std::move(plugin.second));
+  }
+}
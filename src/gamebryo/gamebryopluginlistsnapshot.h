@@ -0,0 +1,34 @@
+#ifndef GAMEBRYOPLUGINLISTSNAPSHOT_H
+#define GAMEBRYOPLUGINLISTSNAPSHOT_H
+
+#include <QString>
+#include <ipluginlist.h>
+
+#include <vector>
+
+/**
+ * @brief Names and states of all plugins, sorted by priority.
+ *
+ * The plugin list is queried once when the snapshot is taken, which must happen on the
+ * thread that owns it. The snapshot itself is immutable and can be shared by writers
+ * running on other threads.
+ */
+class GamebryoPluginListSnapshot
+{
+public:
+  struct Plugin
+  {
+    QString name;
+    MOBase::IPluginList::PluginStates state;
+  };
+
+  GamebryoPluginListSnapshot(const MOBase::IPluginList* pluginList);
+
+  // plugins in priority order
+  const std::vector<Plugin>& plugins() const { return m_Plugins; }
+
+private:
+  std::vector<Plugin> m_Plugins;
+};
+
+#endif  // GAMEBRYOPLUGINLISTSNAPSHOT_H
@@ -0,0 +1,155 @@
+#include "gamebryopluginname.h"
+
+#include <QHashFunctions>
+#include <QVarLengthArray>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GAMEBRYO_PLUGINNAME_SSE2
+#endif
+
+namespace
+{
+
+enum class AsciiResult
+{
+  Equal,
+  Different,
+  NotAscii
+};
+
+char16_t foldAscii(char16_t c)
+{
+  return (c >= u'A' && c <= u'Z') ? static_cast<char16_t>(c | 0x20) : c;
+}
+
+#ifdef GAMEBRYO_PLUGINNAME_SSE2
+
+// lowercases the ASCII letters of 8 characters
+__m128i foldAscii(__m128i v)
+{
+  const __m128i upper = _mm_and_si128(_mm_cmpgt_epi16(v, _mm_set1_epi16('A' - 1)),
+                                      _mm_cmplt_epi16(v, _mm_set1_epi16('Z' + 1)));
+  return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi16(0x20)));
+}
+
+bool hasNonAscii(__m128i v)
+{
+  return _mm_movemask_epi8(_mm_cmpeq_epi16(
+             _mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xff80))),
+             _mm_setzero_si128())) != 0xffff;
+}
+
+#endif
+
+// compares two names of the same length as long as they are ASCII
+AsciiResult compareAscii(const char16_t* lhs, const char16_t* rhs, qsizetype size)
+{
+  bool equal  = true;
+  qsizetype i = 0;
+
+#ifdef GAMEBRYO_PLUGINNAME_SSE2
+  for (; i + 8 <= size; i += 8) {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+
+    if (hasNonAscii(_mm_or_si128(a, b))) {
+      return AsciiResult::NotAscii;
+    }
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(foldAscii(a), foldAscii(b))) != 0xffff) {
+      equal = false;
+    }
+  }
+#endif
+
+  for (; i < size; ++i) {
+    if (lhs[i] > 0x7f || rhs[i] > 0x7f) {
+      return AsciiResult::NotAscii;
+    }
+    if (foldAscii(lhs[i]) != foldAscii(rhs[i])) {
+      equal = false;
+    }
+  }
+
+  return equal ? AsciiResult::Equal : AsciiResult::Different;
+}
+
+bool isAscii(const char16_t* name, qsizetype size)
+{
+  qsizetype i = 0;
+
+#ifdef GAMEBRYO_PLUGINNAME_SSE2
+  for (; i + 8 <= size; i += 8) {
+    if (hasNonAscii(_mm_loadu_si128(reinterpret_cast<const __m128i*>(name + i)))) {
+      return false;
+    }
+  }
+#endif
+
+  for (; i < size; ++i) {
+    if (name[i] > 0x7f) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// folds an ASCII name into out, returns false if the name is not ASCII
+bool foldAscii(const char16_t* name, qsizetype size, char16_t* out)
+{
+  qsizetype i = 0;
+
+#ifdef GAMEBRYO_PLUGINNAME_SSE2
+  for (; i + 8 <= size; i += 8) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(name + i));
+    if (hasNonAscii(v)) {
+      return false;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), foldAscii(v));
+  }
+#endif
+
+  for (; i < size; ++i) {
+    if (name[i] > 0x7f) {
+      return false;
+    }
+    out[i] = foldAscii(name[i]);
+  }
+
+  return true;
+}
+
+}  // namespace
+
+bool pluginNameEquals(QStringView lhs, QStringView rhs)
+{
+  if (lhs.size() == rhs.size()) {
+    switch (compareAscii(lhs.utf16(), rhs.utf16(), lhs.size())) {
+    case AsciiResult::Equal:
+      return true;
+    case AsciiResult::Different:
+      return false;
+    case AsciiResult::NotAscii:
+      break;
+    }
+  } else if (isAscii(lhs.utf16(), lhs.size()) && isAscii(rhs.utf16(), rhs.size())) {
+    return false;
+  }
+
+  // folding is per code point, so names of different lengths can still be equal
+  // when surrogate pairs are involved
+  return lhs.toString().toCaseFolded() == rhs.toString().toCaseFolded();
+}
+
+std::size_t pluginNameHash(QStringView name, std::size_t seed)
+{
+  // plugin names are short, this only allocates for unusually long ones
+  QVarLengthArray<char16_t, 256> folded(name.size());
+  if (foldAscii(name.utf16(), name.size(), folded.data())) {
+    return qHash(QStringView(folded.data(), folded.size()), seed);
+  }
+
+  return qHash(name.toString().toCaseFolded(), seed);
+}
@@ -0,0 +1,49 @@
+#ifndef GAMEBRYOPLUGINNAME_H
+#define GAMEBRYOPLUGINNAME_H
+
+#include <QString>
+#include <QStringView>
+
+#include <cstddef>
+#include <utility>
+
+/**
+ * @brief Compares two plugin names case-insensitively.
+ *
+ * Names that are pure ASCII, which is almost all of them, are folded and compared 8
+ * characters at a time. Other names fall back to full Unicode case folding, so the
+ * result is always the same as comparing QString::toCaseFolded() of both.
+ */
+bool pluginNameEquals(QStringView lhs, QStringView rhs);
+
+/**
+ * @brief Hashes a plugin name case-insensitively, consistent with pluginNameEquals().
+ */
+std::size_t pluginNameHash(QStringView name, std::size_t seed = 0);
+
+/**
+ * @brief Plugin name that compares and hashes case-insensitively, to be used as the
+ * key of a QHash or QSet instead of case-folded copies of names.
+ */
+class GamebryoPluginName
+{
+public:
+  GamebryoPluginName(QString name) : m_Name(std::move(name)) {}
+
+  const QString& name() const { return m_Name; }
+
+  friend bool operator==(const GamebryoPluginName& lhs, const GamebryoPluginName& rhs)
+  {
+    return pluginNameEquals(lhs.m_Name, rhs.m_Name);
+  }
+
+  friend std::size_t qHash(const GamebryoPluginName& key, std::size_t seed = 0)
+  {
+    return pluginNameHash(key.m_Name, seed);
+  }
+
+private:
+  QString m_Name;
+};
+
+#endif  // GAMEBRYOPLUGINNAME_H
@@ -0,0 +1,45 @@
+#include "gamebryopluginstates.h"
+
+using MOBase::IPluginList;
+
+GamebryoPluginStates::GamebryoPluginStates(IPluginList* pluginList)
+    : m_PluginList(pluginList)
+{}
+
+void GamebryoPluginStates::set(const QString& pluginName,
+                               IPluginList::PluginStates state)
+{
+  auto it = m_Index.constFind(pluginName);
+  if (it != m_Index.constEnd()) {
+    m_States[*it].second = state;
+  } else {
+    m_Index.insert(pluginName, m_States.size());
+    m_States.emplace_back(pluginName, state);
+  }
+}
+
+void GamebryoPluginStates::setDefault(const QString& pluginName,
+                                      IPluginList::PluginStates state)
+{
+  if (!m_Index.contains(pluginName)) {
+    m_Index.insert(pluginName, m_States.size());
+    m_States.emplace_back(pluginName, state);
+  }
+}
+
+bool GamebryoPluginStates::contains(const QString& pluginName) const
+{
+  return m_Index.contains(pluginName);
+}
+
+void GamebryoPluginStates::apply()
+{
+  // every setState() call makes the plugin list notify its observers, so skip plugins
+  // whose state would not change and plugins the list does not know about
+  for (const auto& [pluginName, state] : m_States) {
+    const auto current = m_PluginList->state(pluginName);
+    if (current != IPluginList::STATE_MISSING && current != state) {
+      m_PluginList->setState(pluginName, state);
+    }
+  }
+}
@@ -0,0 +1,54 @@
+#ifndef GAMEBRYOPLUGINSTATES_H
+#define GAMEBRYOPLUGINSTATES_H
+
+#include "gamebryopluginname.h"
+
+#include <QHash>
+#include <QString>
+#include <ipluginlist.h>
+
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Collects the desired state of plugins and applies all of them to the plugin
+ * list in one go.
+ *
+ * Plugins are matched case-insensitively. Only states that differ from the current
+ * ones are applied, with one setState() call per plugin since IPluginList has no way
+ * to set many states at once.
+ */
+class GamebryoPluginStates
+{
+public:
+  GamebryoPluginStates(MOBase::IPluginList* pluginList);
+
+  /**
+   * @brief Sets the desired state of a plugin, replacing any previous one.
+   */
+  void set(const QString& pluginName, MOBase::IPluginList::PluginStates state);
+
+  /**
+   * @brief Sets the desired state of a plugin unless one has already been set.
+   */
+  void setDefault(const QString& pluginName, MOBase::IPluginList::PluginStates state);
+
+  /**
+   * @return true if a state has been set for the given plugin
+   */
+  bool contains(const QString& pluginName) const;
+
+  /**
+   * @brief Applies the collected states to the plugin list.
+   */
+  void apply();
+
+private:
+  MOBase::IPluginList* m_PluginList;
+  std::vector<std::pair<QString, MOBase::IPluginList::PluginStates>> m_States;
+
+  // plugin name -> index in m_States
+  QHash<GamebryoPluginName, std::size_t> m_Index;
+};
+
+#endif  // GAMEBRYOPLUGINSTATES_H
@@ -1,7 +1,10 @@
 #include "gamebryounmanagedmods.h"
+#include "gamebryopluginname.h"
 #include "gamegamebryo.h"
 #include <pluginsetting.h>
 
+#include <QSet>
+
 GamebryoUnmangedMods::GamebryoUnmangedMods(const GameGamebryo* game) : m_Game(game) {}
 
 GamebryoUnmangedMods::~GamebryoUnmangedMods() {}
@@ -10,13 +13,16 @@ QStringList GamebryoUnmangedMods::mods(bool onlyOfficial) const
 {
   QStringList result;
 
-  QStringList dlcPlugins  = m_Game->DLCPlugins();
-  QStringList mainPlugins = m_Game->primaryPlugins();
+  const QStringList dlcList  = m_Game->DLCPlugins();
+  const QStringList mainList = m_Game->primaryPlugins();
+
+  const QSet<GamebryoPluginName> dlcPlugins(dlcList.begin(), dlcList.end());
+  const QSet<GamebryoPluginName> mainPlugins(mainList.begin(), mainList.end());
 
   QDir dataDir(m_Game->dataDirectory());
   for (const QString& fileName : dataDir.entryList({"*.esp", "*.esl", "*.esm"})) {
-    if (!mainPlugins.contains(fileName, Qt::CaseInsensitive) &&
-        (!onlyOfficial || dlcPlugins.contains(fileName, Qt::CaseInsensitive))) {
+    if (!mainPlugins.contains(fileName) &&
+        (!onlyOfficial || dlcPlugins.contains(fileName))) {
       result.append(fileName.chopped(4));  // trims the extension off
     }
   }
@@ -0,0 +1,49 @@
+#include "gamebryowindows1252.h"
+
+#include <algorithm>
+#include <array>
+
+namespace
+{
+
+// characters of the bytes 0x80 to 0x9f, the others are the same as in Latin-1
+constexpr std::array<char16_t, 32> HIGH_CHARACTERS = {
+    0x20ac, 0x0081, 0x201a, 0x0192, 0x201e, 0x2026, 0x2020, 0x2021,
+    0x02c6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008d, 0x017d, 0x008f,
+    0x0090, 0x2018, 0x2019, 0x201c, 0x201d, 0x2022, 0x2013, 0x2014,
+    0x02dc, 0x2122, 0x0161, 0x203a, 0x0153, 0x009d, 0x017e, 0x0178};
+
+}  // namespace
+
+QString decodeWindows1252(QByteArrayView data)
+{
+  QString result(data.size(), Qt::Uninitialized);
+  QChar* out = result.data();
+  for (qsizetype i = 0; i < data.size(); ++i) {
+    const auto byte = static_cast<unsigned char>(data[i]);
+    out[i] = QChar(byte >= 0x80 && byte < 0xa0 ? HIGH_CHARACTERS[byte - 0x80]
+                                               : static_cast<char16_t>(byte));
+  }
+  return result;
+}
+
+std::optional<QByteArray> encodeWindows1252(QStringView text)
+{
+  QByteArray result(text.size(), Qt::Uninitialized);
+  char* out = result.data();
+  for (qsizetype i = 0; i < text.size(); ++i) {
+    const char16_t c = text[i].unicode();
+    if (c < 0x80 || (c >= 0xa0 && c < 0x100)) {
+      out[i] = static_cast<char>(c);
+      continue;
+    }
+
+    const auto it = std::find(HIGH_CHARACTERS.begin(), HIGH_CHARACTERS.end(), c);
+    if (it == HIGH_CHARACTERS.end()) {
+      return std::nullopt;
+    }
+
+    out[i] = static_cast<char>(0x80 + (it - HIGH_CHARACTERS.begin()));
+  }
+  return result;
+}
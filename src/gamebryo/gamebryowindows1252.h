@@ -0,0 +1,27 @@
+#ifndef GAMEBRYOWINDOWS1252_H
+#define GAMEBRYOWINDOWS1252_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QStringView>
+
+#include <optional>
+
+/**
+ * @brief Decodes Windows-1252, the code page the games use for their INI files and the
+ * paths in their archives. Every byte decodes to a character, the unassigned ones to
+ * the control character of the same value like MultiByteToWideChar() does, so encoding
+ * the result gives the same bytes back.
+ */
+QString decodeWindows1252(QByteArrayView data);
+
+/**
+ * @brief Encodes text in Windows-1252, the reverse of decodeWindows1252().
+ *
+ * @return the encoded text, or nullopt if it has characters that Windows-1252 cannot
+ * represent
+ */
+std::optional<QByteArray> encodeWindows1252(QStringView text);
+
+#endif  // GAMEBRYOWINDOWS1252_H
@@ -2,6 +2,7 @@
 
 #include "bsainvalidation.h"
 #include "dataarchives.h"
+#include "gamebryoinitransaction.h"
 #include "gamebryomoddatacontent.h"
 #include "gamebryosavegame.h"
 #include "gameplugins.h"
@@ -20,7 +21,6 @@
 #include <QFileInfo>
 #include <QIcon>
 #include <QJsonDocument>
-#include <QSettings>
 #include <QStandardPaths>
 #include <QtDebug>
 #include <QtGlobal>
@@ -225,10 +225,11 @@ bool GameGamebryo::prepareIni(const QString& exec)
 
     QString profileIni = basePath + "/" + iniFiles()[0];
 
-    QSettings ini(profileIni, QSettings::IniFormat);
-
-    if (ini.value(u"Launcher/bEnableFileSelection"_s, "0").toString() != "1") {
-      ini.setValue(u"Launcher/bEnableFileSelection"_s, "1");
+    GamebryoIniTransaction transaction;
+    transaction.file(profileIni)->setValue(u"Launcher/bEnableFileSelection"_s, "1");
+    if (!transaction.commit()) {
+      qWarning("failed to enable file selection in \"%s\"",
+               qUtf8Printable(profileIni));
     }
   }
 
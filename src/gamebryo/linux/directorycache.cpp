@@ -0,0 +1,67 @@
+#include "directorycache.h"
+
+#include <QDirListing>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+DirectoryCache& DirectoryCache::instance()
+{
+  static DirectoryCache cache;
+  return cache;
+}
+
+bool DirectoryCache::Listing::isStable() const
+{
+  return lastModified.isValid() && lastModified.msecsTo(listedAt) > 1000;
+}
+
+DirectoryCache::Listing DirectoryCache::readListing(const QString& directory,
+                                                    const QDateTime& lastModified)
+{
+  Listing listing;
+  listing.lastModified = lastModified;
+  listing.listedAt     = QDateTime::currentDateTime();
+
+  for (const QDirListing::DirEntry& dirEntry :
+       QDirListing(directory, QDirListing::IteratorFlag::FilesOnly)) {
+    const QString fileName = dirEntry.fileName();
+    listing.files.insert(fileName.toCaseFolded(), fileName);
+  }
+
+  return listing;
+}
+
+QString DirectoryCache::findFile(const QString& path)
+{
+  const QFileInfo info(path);
+  const QString directory = info.absolutePath();
+  const QString key       = info.fileName().toCaseFolded();
+
+  // a single stat of the directory replaces reading all of its entries
+  const QDateTime lastModified = QFileInfo(directory).lastModified();
+
+  QMutexLocker lock(&m_Mutex);
+
+  auto it = m_Listings.find(directory);
+  if (it == m_Listings.end() || it->lastModified != lastModified || !it->isStable()) {
+    it = m_Listings.insert(directory, readListing(directory, lastModified));
+  }
+
+  auto file = it->files.constFind(key);
+  if (file != it->files.constEnd()) {
+    return directory + "/" + *file;
+  }
+
+  return path;
+}
+
+void DirectoryCache::invalidate(const QString& directory)
+{
+  QMutexLocker lock(&m_Mutex);
+  m_Listings.remove(QFileInfo(directory).absoluteFilePath());
+}
+
+QString findFileCaseInsensitive(const QString& path)
+{
+  return DirectoryCache::instance().findFile(path);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+/**
+ * @brief Caches case-folded directory listings so that case-insensitive file lookups
+ * do not have to read the whole directory every time.
+ *
+ * A directory is listed on first use and listed again only when its modification time
+ * changes, which happens whenever an entry is created, removed or renamed.
+ */
+class DirectoryCache
+{
+public:
+  static DirectoryCache& instance();
+
+  /**
+   * @brief Finds a file in the specified path, matching its name case-insensitively.
+   * @param path The path to the file being searched, including the file name.
+   * @return The absolute file path of the matching file if found, or the original
+   * path if no matching file exists.
+   */
+  QString findFile(const QString& path);
+
+  /**
+   * @brief Drops the cached listing of a directory, forcing it to be read again on the
+   * next lookup.
+   */
+  void invalidate(const QString& directory);
+
+private:
+  struct Listing
+  {
+    QDateTime lastModified;
+    QDateTime listedAt;
+
+    // case-folded file name -> file name on disk
+    QHash<QString, QString> files;
+
+    // the directory may still change within the resolution of its timestamp, so a
+    // listing taken right after a modification cannot be trusted
+    bool isStable() const;
+  };
+
+  static Listing readListing(const QString& directory, const QDateTime& lastModified);
+
+  QMutex m_Mutex;
+  QHash<QString, Listing> m_Listings;
+};
+
+/**
+ * Finds a file in the specified path, matching its name case-insensitively, and
+ * returns its absolute file path if found. If no matching file is found, the original
+ * path is returned.
+ * @param path The path to the file being searched, including the
+ * file name.
+ * @return The absolute file path of the matching file if found, or the
+ * original  path if no matching file exists.
+ */
+QString findFileCaseInsensitive(const QString& path);